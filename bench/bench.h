@@ -0,0 +1,45 @@
+#pragma once
+// Minimal timing helpers shared by the host benchmarks in this folder.
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace bench {
+
+/// @brief CPU timestamp counter (0 when not available on the host architecture)
+inline uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+template<typename T> inline void do_not_optimize(T const &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+/// @brief Runs 'func' repeatedly for (at least) 'min_seconds' and returns the
+/// best (minimum) time in seconds of a single run ('name' == nullptr: don't print the result)
+template<typename F> double run(const char *name, F &&func, double min_seconds = 0.3) {
+  using clock = std::chrono::steady_clock;
+  double best = 1e30;
+  int runs = 0;
+  auto start = clock::now();
+  do {
+    auto t0 = clock::now();
+    func();
+    double elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+    if (elapsed < best)
+      best = elapsed;
+    ++runs;
+  } while (std::chrono::duration<double>(clock::now() - start).count() < min_seconds);
+  if (name)
+    printf("%-40s %10.3f us/run (%d runs)\n", name, best * 1e6, runs);
+  return best;
+}
+
+}  // namespace bench
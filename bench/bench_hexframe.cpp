@@ -0,0 +1,231 @@
+// Host benchmark for the HEX frame codec (m3_ve_reg::HexFrameDecoder / HexFrame::encode_).
+// It compares the legacy per-byte decoder (range compares) against the table driven/bulk
+// decoder used by FrameHandler, reporting frames/s for both. (The encoder is unchanged: a
+// 16 bit digits pair table was tried and measured no faster than HEX_DIGITS_MAP.)
+// It also measures the decoding cost per byte with the RX encoded mirror enabled/disabled
+// (see VEDIRECT_HEXFRAME_RX_MIRROR) and the cost of lazily re-encoding every frame when disabled.
+// Every row is the best of a 0.3 s run: on a loaded host the '7 bytes chunks' ratio easily swings
+// by +/-30% between runs so compare a few runs (on an idle host) before drawing conclusions.
+//
+// build (a single command line) & run from the repository root:
+//   g++ -O2 -std=gnu++20 -Icomponents/m3_vedirect -o bench/bench_hexframe.out bench/bench_hexframe.cpp
+//     components/m3_vedirect/ve_reg_frame.cpp components/m3_vedirect/ve_reg.cpp
+//   bench/bench_hexframe.out
+#include "bench.h"
+
+#include "ve_reg_frame.h"
+
+using namespace m3_ve_reg;
+
+// Legacy (baseline) decoder, kept here verbatim for comparison
+namespace legacy {
+
+struct Decoder {
+  uint8_t raw[VEDIRECT_HEXFRAME_MAX_SIZE + 2];
+  char encoded[VEDIRECT_HEXFRAME_MAX_SIZE * 2 + 6];
+  uint8_t *raw_end;
+  char *encoded_end;
+  bool hinibble;
+  uint8_t checksum;
+
+  void init() {
+    this->checksum = 0x55;
+    this->hinibble = false;
+    this->raw_end = this->raw;
+    *this->raw_end = 0;
+    this->encoded_end = this->encoded + 1;
+  }
+
+  HexFrame::DecodeResult decode(char hexdigit) {
+    if (this->raw_end >= this->raw + sizeof(this->raw))
+      return HexFrame::DecodeResult::Overflow;
+    if ((hexdigit >= '0') && (hexdigit <= '9')) {
+      *this->encoded_end++ = hexdigit;
+      hexdigit -= '0';
+    } else if ((hexdigit >= 'A') && (hexdigit <= 'F')) {
+      *this->encoded_end++ = hexdigit;
+      hexdigit -= 55;
+    } else if (hexdigit == '\n') {
+      *this->encoded_end++ = '\n';
+      if (!this->hinibble)
+        return HexFrame::DecodeResult::CodingError;
+      if (this->checksum)
+        return HexFrame::DecodeResult::ChecksumError;
+      --this->raw_end;
+      return HexFrame::DecodeResult::Valid;
+    } else {
+      return HexFrame::DecodeResult::CodingError;
+    }
+    if (this->hinibble) {
+      this->hinibble = false;
+      *this->raw_end = hexdigit << 4;
+    } else {
+      this->hinibble = true;
+      *this->raw_end |= hexdigit;
+      this->checksum -= *this->raw_end++;
+    }
+    return HexFrame::DecodeResult::Continue;
+  }
+};
+
+}  // namespace legacy
+
+class BenchFrameHandler : public FrameHandler {
+ public:
+  int valid{0};
+  int errors{0};
+  uint32_t fingerprint{0};
+  // when set, every valid frame encoding is appended here (as a consumer like 'rawhexframe' would do)
+  std::string *encoded{};
+
+  using FrameHandler::set_hexframe_mirror;
+
+  void clear() {
+    this->reset();
+    this->valid = this->errors = 0;
+    this->fingerprint = 0;
+    if (this->encoded)
+      this->encoded->clear();
+  }
+
+ private:
+  void on_frame_hex_(const RxHexFrame &hexframe) override {
+    ++this->valid;
+    for (auto data = hexframe.begin(); data < hexframe.end(); ++data)
+      this->fingerprint = this->fingerprint * 31 + *data;
+    if (this->encoded)
+      this->encoded->append(hexframe.encoded(), hexframe.encoded_size());
+  }
+  void on_frame_hex_error_(Error error) override { ++this->errors; }
+};
+
+int main() {
+  // Build a representative stream: short GET/SET replies, Async notifications and a few long (string) replies
+  std::string stream;
+  int frames_count = 0;
+  {
+    HexFrameT<VEDIRECT_HEXFRAME_MAX_SIZE> hexframe;
+    uint32_t seed = 1;
+    for (int i = 0; i < 1000; ++i) {
+      seed = seed * 1103515245 + 12345;
+      switch (i % 10) {
+        case 0:
+          hexframe.command(HEXFRAME::COMMAND::PingResp);
+          break;
+        case 1: {
+          char serial[24] = "HQ2246ABCDEF0123456789";
+          hexframe.command(HEXFRAME::COMMAND::Get, 0x010A, serial, sizeof(serial));
+          break;
+        }
+        case 2:
+        case 3:
+          hexframe.command_set<uint8_t>(0x0200 + i % 7, seed >> 24);
+          break;
+        case 4:
+        case 5:
+        case 6:
+          hexframe.command(HEXFRAME::COMMAND::Async, 0xEDD0 + i % 16, &seed, 2);
+          break;
+        default:
+          hexframe.command(HEXFRAME::COMMAND::Get, 0xED8D + i % 16, &seed, 4);
+          break;
+      }
+      stream.append(hexframe.encoded(), hexframe.encoded_size());
+      ++frames_count;
+    }
+  }
+  const uint8_t *stream_begin = (const uint8_t *) stream.data();
+  const uint8_t *stream_end = stream_begin + stream.size();
+  printf("HEX stream: %d frames, %zu bytes\n", frames_count, stream.size());
+
+  int legacy_valid = 0;
+  uint32_t legacy_fingerprint = 0;
+  double legacy_decode = bench::run("decode legacy per-byte", [&]() {
+    legacy::Decoder decoder;
+    legacy_valid = 0;
+    legacy_fingerprint = 0;
+    bool in_frame = false;
+    for (auto data = stream_begin; data < stream_end; ++data) {
+      if (!in_frame) {
+        if (*data == ':') {
+          decoder.init();
+          in_frame = true;
+        }
+        continue;
+      }
+      switch (decoder.decode(*data)) {
+        case HexFrame::DecodeResult::Continue:
+          continue;
+        case HexFrame::DecodeResult::Valid:
+          ++legacy_valid;
+          for (auto raw = decoder.raw; raw < decoder.raw_end; ++raw)
+            legacy_fingerprint = legacy_fingerprint * 31 + *raw;
+          [[fallthrough]];
+        default:
+          in_frame = false;
+      }
+    }
+  });
+
+  BenchFrameHandler handler;
+  double bulk_decode = bench::run("decode FrameHandler (whole span)", [&]() {
+    handler.clear();
+    handler.decode((uint8_t *) stream_begin, (uint8_t *) stream_end);
+  });
+  if ((handler.valid != legacy_valid) || (handler.fingerprint != legacy_fingerprint) || handler.errors) {
+    printf("MISMATCH: legacy=%d new=%d errors=%d\n", legacy_valid, handler.valid, handler.errors);
+    return 1;
+  }
+
+  double split_decode = bench::run("decode FrameHandler (7 bytes chunks)", [&]() {
+    handler.clear();
+    for (auto data = stream_begin; data < stream_end; data += 7) {
+      auto data_end = data + 7 < stream_end ? data + 7 : stream_end;
+      handler.decode((uint8_t *) data, (uint8_t *) data_end);
+    }
+  });
+  if ((handler.valid != legacy_valid) || (handler.fingerprint != legacy_fingerprint) || handler.errors) {
+    printf("MISMATCH (split): legacy=%d new=%d errors=%d\n", legacy_valid, handler.valid, handler.errors);
+    return 1;
+  }
+
+  // RX mirror on/off: decode cost per byte and cost of lazily re-encoding every received frame
+  double mirror_decode[2], mirror_encode[2];
+  std::string encoded;
+  encoded.reserve(stream.size());
+  for (int mirror = 1; mirror >= 0; --mirror) {
+    handler.set_hexframe_mirror(mirror);
+    handler.encoded = nullptr;
+    mirror_decode[mirror] = bench::run(mirror ? "decode mirror on" : "decode mirror off", [&]() {
+      handler.clear();
+      handler.decode((uint8_t *) stream_begin, (uint8_t *) stream_end);
+    });
+    if ((handler.valid != legacy_valid) || (handler.fingerprint != legacy_fingerprint) || handler.errors) {
+      printf("MISMATCH (mirror=%d): legacy=%d new=%d errors=%d\n", mirror, legacy_valid, handler.valid, handler.errors);
+      return 1;
+    }
+    handler.encoded = &encoded;
+    mirror_encode[mirror] = bench::run(mirror ? "decode mirror on + encoded()" : "decode mirror off + encoded()", [&]() {
+      handler.clear();
+      handler.decode((uint8_t *) stream_begin, (uint8_t *) stream_end);
+    });
+    if (encoded != stream) {
+      printf("MISMATCH (mirror=%d): encoded() differs from the input stream\n", mirror);
+      return 1;
+    }
+  }
+  handler.encoded = nullptr;
+
+  printf("\n%-40s %14s\n", "", "frames/s");
+  printf("%-40s %14.0f\n", "decode legacy per-byte", frames_count / legacy_decode);
+  printf("%-40s %14.0f  (x%.2f)\n", "decode bulk (whole span)", frames_count / bulk_decode,
+         legacy_decode / bulk_decode);
+  printf("%-40s %14.0f  (x%.2f)\n", "decode bulk (7 bytes chunks)", frames_count / split_decode,
+         legacy_decode / split_decode);
+  printf("\n%-40s %14s\n", "", "ns/byte");
+  printf("%-40s %14.3f\n", "decode mirror on", mirror_decode[1] * 1e9 / stream.size());
+  printf("%-40s %14.3f\n", "decode mirror off", mirror_decode[0] * 1e9 / stream.size());
+  printf("%-40s %14.3f\n", "decode mirror on + encoded()", mirror_encode[1] * 1e9 / stream.size());
+  printf("%-40s %14.3f\n", "decode mirror off + encoded()", mirror_encode[0] * 1e9 / stream.size());
+  return 0;
+}
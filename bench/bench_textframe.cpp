@@ -0,0 +1,381 @@
+// Host benchmark for the TEXT frame parser (m3_ve_reg::FrameHandler Name/Value/Checksum states).
+// It reports the CPU cost of processing a full 1-second TEXT block from an MPPT and from a BMV,
+// both when the block is fed at once and when it is fed in UART-like chunks, side by side with
+// the legacy pipeline (the 'legacy' and 'x' columns). Both sides do the same job, i.e. what the
+// Manager and its entities do with every TEXT frame:
+// - legacy: per-byte parser storing every record, then (per record) a label lookup in the
+//   registers map and the value conversion through strtof (numeric) or strtoumax (enum/bitmask)
+// - current: FrameHandler binding the records through on_frame_text_name_ (lookup by the label
+//   hash computed while parsing) and the entities using TextRecord::numeric
+// Text values (i.e. serial number) are not converted on either side.
+// The 'all' rows have a register for every label (as with auto-create) while the 'bound' rows only
+// have a few (as when auto-create is off and few entities are configured): the legacy pipeline
+// still stores every record and looks all of them up while the current parser only checksums
+// the values of the unbound ones. The Manager TEXT shape cache is not part of the bench.
+//
+// build (a single command line) & run from the repository root:
+//   g++ -O2 -std=gnu++20 -Icomponents/m3_vedirect -o bench/bench_textframe.out bench/bench_textframe.cpp
+//     components/m3_vedirect/ve_reg_frame.cpp components/m3_vedirect/ve_reg.cpp
+//   bench/bench_textframe.out
+#include "bench.h"
+#include "streams.h"
+
+#include "containers.h"
+#include "ve_reg_frame.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace m3_ve_reg;
+
+// Mimics the registers (entities) bound to TEXT labels and the Manager TextRegistersMap
+struct BenchRegister {
+  enum Kind { NUMERIC, ENUM, TEXT };
+  Kind kind;
+  float state;
+  uint32_t raw;
+  const char *text;
+};
+
+struct hash_label {
+  // same as Manager hash_textlabel (and FrameHandler::text_label_hash)
+  constexpr size_t operator()(const char *s) const {
+    unsigned char hash = *s;
+    while (auto _s = *++s)
+      hash = (hash << 1) + _s;
+    return hash;
+  }
+};
+struct compare_label {
+  int operator()(const char *key_low, const char *key_high) const { return strcmp(key_high, key_low); }
+};
+typedef esphome::m3_vedirect::TinyMap<16, const char *, BenchRegister *,
+                                      esphome::m3_vedirect::SimpleBucket<const char *, BenchRegister *>, hash_label,
+                                      compare_label>
+    registers_map_t;
+
+// Legacy (baseline) per-byte TEXT parser, kept here for comparison: the Name/Value/Checksum states
+// of the former FrameHandler::decode (HEX frames are not part of these streams). It stores every
+// record (there was no label binding) so the 'bound' rows use it unchanged. It doesn't hash the
+// labels nor accumulate the numeric values (work that used to be done later, per record, by the
+// consumers) so it is a lower bound of the former per-frame cost.
+namespace legacy {
+
+struct TextParser {
+  // (was VEDIRECT_RECORDS_COUNT = 22: raised so that the BMV block of these streams fits)
+  static const int RECORDS_COUNT = 32;
+  enum State { Idle, Name, Value, Checksum };
+  struct TextRecord {
+    char name[VEDIRECT_NAME_LEN];
+    char value[VEDIRECT_VALUE_LEN];
+  };
+  State frame_state{Idle};
+  uint8_t text_checksum;
+  TextRecord *text_records[RECORDS_COUNT]{};
+  uint8_t text_records_count;
+  TextRecord *text_record;
+  char *text_record_write;
+  char *text_record_write_end;
+  int valid{0};
+  int errors{0};
+  int records{0};
+  registers_map_t *registers{};
+
+  ~TextParser() {
+    for (auto text_record : this->text_records)
+      delete text_record;
+  }
+
+  void clear() {
+    this->frame_state = Idle;
+    this->valid = this->errors = this->records = 0;
+  }
+
+  // the former Manager::on_frame_text_ and Register::parse_text
+  void on_frame_text() {
+    for (uint8_t i = 0; i < this->text_records_count; ++i) {
+      const TextRecord *text_record = this->text_records[i];
+      auto bucket = this->registers->find(text_record->name);
+      if (!bucket)
+        continue;
+      ++this->records;
+      auto reg = bucket->bucket_value();
+      switch (reg->kind) {
+        case BenchRegister::NUMERIC: {
+          char *endptr;
+          reg->state = strtof(text_record->value, &endptr) * 0.001f;
+          if (*endptr)
+            reg->state = NAN;
+          break;
+        }
+        case BenchRegister::ENUM:
+          reg->raw = strtoumax(text_record->value, nullptr, 0);
+          break;
+        default:
+          reg->text = text_record->value;
+          break;
+      }
+      bench::do_not_optimize(*reg);
+    }
+  }
+
+  void name_start() {
+    TextRecord *text_record = this->text_records[this->text_records_count];
+    if (!text_record)
+      this->text_records[this->text_records_count] = text_record = new TextRecord;
+    this->text_record = text_record;
+    this->text_record_write = text_record->name;
+    this->text_record_write_end = this->text_record_write + sizeof(text_record->name);
+  }
+
+  void value_start() {
+    this->text_record_write = this->text_record->value;
+    this->text_record_write_end = this->text_record_write + sizeof(this->text_record->value);
+  }
+
+  void decode(const uint8_t *data_begin, const uint8_t *data_end) {
+    uint8_t data;
+    switch (this->frame_state) {
+      case Name:
+        goto handle_state_name;
+      case Value:
+        goto handle_state_value;
+      case Checksum:
+        goto handle_state_checksum;
+      default:
+        goto handle_state_idle;
+    }
+  handle_state_name:
+    while (data_begin < data_end) {
+      data = *data_begin++;
+      if (data == '\t') {
+        this->text_checksum += '\t';
+        *this->text_record_write = 0;
+        if (strcmp(this->text_record->name, "Checksum")) {
+          this->value_start();
+          this->frame_state = Value;
+          goto handle_state_value;
+        }
+        this->frame_state = Checksum;
+        goto handle_state_checksum;
+      }
+      this->text_checksum += data;
+      *this->text_record_write = data;
+      if (++this->text_record_write >= this->text_record_write_end) {
+        ++this->errors;
+        this->frame_state = Idle;
+        goto handle_state_idle;
+      }
+    }
+    return;
+  handle_state_value:
+    while (data_begin < data_end) {
+      data = *data_begin++;
+      switch (data) {
+        case '\n':
+          this->text_checksum += '\n';
+          *this->text_record_write = 0;
+          if (++this->text_records_count >= RECORDS_COUNT) {
+            ++this->errors;
+            this->frame_state = Idle;
+            goto handle_state_idle;
+          }
+          this->name_start();
+          this->frame_state = Name;
+          goto handle_state_name;
+        case '\r':
+          this->text_checksum += '\r';
+          break;
+        default:
+          this->text_checksum += data;
+          *this->text_record_write = data;
+          if (++this->text_record_write >= this->text_record_write_end) {
+            ++this->errors;
+            this->frame_state = Idle;
+            goto handle_state_idle;
+          }
+      }
+    }
+    return;
+  handle_state_idle:
+    while (data_begin < data_end) {
+      switch (*data_begin++) {
+        case '\n':
+          this->text_checksum += '\n';
+          this->text_records_count = 0;
+          this->name_start();
+          this->frame_state = Name;
+          goto handle_state_name;
+        case '\r':
+          this->text_checksum = '\r';
+        default:
+          break;
+      }
+    }
+    return;
+  handle_state_checksum:
+    if (data_begin < data_end) {
+      if ((uint8_t) (this->text_checksum + *data_begin++)) {
+        ++this->errors;
+      } else {
+        ++this->valid;
+        this->on_frame_text();
+      }
+      this->frame_state = Idle;
+      goto handle_state_idle;
+    }
+  }
+};
+
+}  // namespace legacy
+
+class BenchFrameHandler : public FrameHandler {
+ public:
+  int valid{0};
+  int errors{0};
+  int records{0};
+  registers_map_t *registers{};
+
+  void clear() {
+    this->reset();
+    this->valid = this->errors = this->records = 0;
+  }
+
+ private:
+  // the Manager::on_frame_text_name_ fallback (no shape cache): a single lookup by the parser hash
+  bool on_frame_text_name_(TextRecord &text_record, const char *name, uint8_t hash) override {
+    auto bucket = this->registers->find(name, hash);
+    text_record.binding = bucket;
+    return bucket;
+  }
+  // the Manager::on_frame_text_ and the entities using the integer accumulated by the parser
+  void on_frame_text_(const TextFrame &textframe) override {
+    ++this->valid;
+    for (uint8_t i = 0; i < textframe.size(); ++i) {
+      const TextRecord &text_record = textframe[i];
+      auto bucket = (registers_map_t::bucket_type *) text_record.binding;
+      if (!bucket)
+        continue;
+      ++this->records;
+      auto reg = bucket->bucket_value();
+      switch (reg->kind) {
+        case BenchRegister::NUMERIC:
+          reg->state = text_record.numeric_ok ? text_record.numeric * 0.001f : NAN;
+          break;
+        case BenchRegister::ENUM:
+          reg->raw = text_record.numeric;
+          break;
+        default:
+          reg->text = textframe.value(text_record);
+          break;
+      }
+      bench::do_not_optimize(*reg);
+    }
+  }
+  void on_frame_text_error_(Error error) override { ++this->errors; }
+};
+
+int main() {
+  static const int BLOCKS = 200;
+  static const struct {
+    const char *name;
+    bench::text_records_t (*records)(int);
+    std::vector<std::string> bound;
+  } DEVICES[] = {{"MPPT", bench::mppt_records, {"V", "I", "PPV", "CS", "H20"}},
+                 {"BMV", bench::bmv_records, {"V", "I", "P", "SOC", "TTG"}}};
+
+  printf("%-28s %8s %10s %14s %12s %10s %14s %8s\n", "", "bytes", "records", "cycles/block", "cycles/byte", "ns/byte",
+         "legacy c/block", "x");
+  BenchFrameHandler handler;
+  legacy::TextParser legacy_parser;
+  for (auto &device : DEVICES) {
+    std::string stream;
+    for (int seq = 0; seq < BLOCKS; ++seq)
+      stream += bench::text_block(device.records(seq));
+    // a register per label ('all') or only for the 'bound' labels
+    auto records = device.records(0);
+    std::vector<BenchRegister> registers(records.size());
+    registers_map_t registers_all, registers_bound;
+    for (size_t i = 0; i < records.size(); ++i) {
+      auto label = records[i].first.c_str();
+      auto value = records[i].second.c_str();
+      char *endptr;
+      strtol(value, &endptr, 10);
+      if (!strncmp(value, "0x", 2) || !strcmp(label, "CS") || !strcmp(label, "MPPT") || !strcmp(label, "ERR") ||
+          !strcmp(label, "AR") || !strcmp(label, "MON")) {
+        registers[i].kind = BenchRegister::ENUM;
+      } else {
+        registers[i].kind = *endptr ? BenchRegister::TEXT : BenchRegister::NUMERIC;
+      }
+      registers_all.insert(label, &registers[i]);
+      for (auto &bound : device.bound) {
+        if (bound == label)
+          registers_bound.insert(label, &registers[i]);
+      }
+    }
+    for (auto bound : {false, true}) {
+      handler.registers = legacy_parser.registers = bound ? &registers_bound : &registers_all;
+      for (size_t chunk_size : {stream.size(), (size_t) 64, (size_t) 16}) {
+        uint64_t cycles = UINT64_MAX;
+        double seconds = bench::run(nullptr, [&]() {
+          handler.clear();
+          auto data = (uint8_t *) stream.data();
+          auto data_end = data + stream.size();
+          uint64_t start = bench::cycles();
+          for (; data < data_end; data += chunk_size)
+            handler.decode(data, data + chunk_size < data_end ? data + chunk_size : data_end);
+          uint64_t elapsed = bench::cycles() - start;
+          if (elapsed < cycles)
+            cycles = elapsed;
+        });
+        if ((handler.valid != BLOCKS) || handler.errors) {
+          printf("%s: unexpected result valid=%d errors=%d\n", device.name, handler.valid, handler.errors);
+          return 1;
+        }
+        std::vector<BenchRegister> states(registers);
+        uint64_t legacy_cycles = UINT64_MAX;
+        double legacy_seconds = bench::run(nullptr, [&]() {
+          legacy_parser.clear();
+          auto data = (const uint8_t *) stream.data();
+          auto data_end = data + stream.size();
+          uint64_t start = bench::cycles();
+          for (; data < data_end; data += chunk_size)
+            legacy_parser.decode(data, data + chunk_size < data_end ? data + chunk_size : data_end);
+          uint64_t elapsed = bench::cycles() - start;
+          if (elapsed < legacy_cycles)
+            legacy_cycles = elapsed;
+        });
+        if ((legacy_parser.valid != BLOCKS) || legacy_parser.errors || (legacy_parser.records != handler.records)) {
+          printf("%s: unexpected legacy result valid=%d errors=%d records=%d\n", device.name, legacy_parser.valid,
+                 legacy_parser.errors, legacy_parser.records);
+          return 1;
+        }
+        for (size_t i = 0; i < registers.size(); ++i) {
+          auto &state = states[i], &legacy_state = registers[i];
+          if (((state.kind == BenchRegister::NUMERIC) && (state.state != legacy_state.state)) ||
+              ((state.kind == BenchRegister::ENUM) && (state.raw != legacy_state.raw)) ||
+              ((state.kind == BenchRegister::TEXT) && strcmp(state.text ? state.text : "",
+                                                             legacy_state.text ? legacy_state.text : ""))) {
+            printf("%s: state mismatch on '%s'\n", device.name, records[i].first.c_str());
+            return 1;
+          }
+        }
+        char name[64];
+        if (chunk_size == stream.size()) {
+          snprintf(name, sizeof(name), "%s %s (whole stream)", device.name, bound ? "bound" : "all");
+        } else {
+          snprintf(name, sizeof(name), "%s %s (%zu bytes chunks)", device.name, bound ? "bound" : "all",
+                   chunk_size);
+        }
+        // (cycles are not available on every host: the ratio is then computed on the wall time)
+        printf("%-28s %8zu %10d %14.0f %12.2f %10.3f %14.0f %8.2f\n", name, stream.size() / BLOCKS,
+               handler.records / BLOCKS, (double) cycles / BLOCKS, (double) cycles / stream.size(),
+               seconds * 1e9 / stream.size(), (double) legacy_cycles / BLOCKS,
+               cycles ? (double) legacy_cycles / cycles : legacy_seconds / seconds);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,104 @@
+// Host benchmark for the conversion of TEXT record values into sensor states.
+// It compares, per TEXT frame, the former strtof based conversion (Sensor::parse_text_default_)
+// against the integer accumulated by the frame parser (TextRecord::numeric) scaled by the sensor
+// 'text_scale_'. The 'decode only' rows are the baseline cost of parsing the frame itself.
+//
+// build (a single command line) & run from the repository root:
+//   g++ -O2 -std=gnu++20 -Icomponents/m3_vedirect -o bench/bench_textvalues.out bench/bench_textvalues.cpp
+//     components/m3_vedirect/ve_reg_frame.cpp components/m3_vedirect/ve_reg.cpp
+//   bench/bench_textvalues.out
+#include "bench.h"
+#include "streams.h"
+
+#include "ve_reg_frame.h"
+
+#include <cmath>
+#include <cstdlib>
+
+using namespace m3_ve_reg;
+
+class BenchFrameHandler : public FrameHandler {
+ public:
+  enum Mode { DECODE_ONLY, STRTOF, NUMERIC };
+  Mode mode{DECODE_ONLY};
+  int valid{0};
+  int numeric{0};
+  // mimics the sensor entities state
+  float states[64];
+
+  void clear() {
+    this->reset();
+    this->valid = this->numeric = 0;
+  }
+
+ private:
+  void on_frame_text_(const TextFrame &textframe) override {
+    ++this->valid;
+    const float text_scale = 0.001f;
+    for (uint8_t i = 0; i < textframe.size(); ++i) {
+      const TextRecord &text_record = textframe[i];
+      float value;
+      switch (this->mode) {
+        case STRTOF: {
+          char *endptr;
+          value = strtof(textframe.value(text_record), &endptr) * text_scale;
+          if (*endptr)
+            value = NAN;
+          break;
+        }
+        case NUMERIC:
+          value = text_record.numeric_ok ? text_record.numeric * text_scale : NAN;
+          break;
+        default:
+          continue;
+      }
+      this->numeric += !std::isnan(value);
+      this->states[i] = value;
+    }
+    bench::do_not_optimize(this->states);
+  }
+};
+
+int main() {
+  static const int BLOCKS = 200;
+  static const struct {
+    const char *name;
+    bench::text_records_t (*records)(int);
+  } DEVICES[] = {{"MPPT", bench::mppt_records}, {"BMV", bench::bmv_records}};
+  static const struct {
+    const char *name;
+    BenchFrameHandler::Mode mode;
+  } MODES[] = {{"decode only", BenchFrameHandler::DECODE_ONLY},
+               {"strtof", BenchFrameHandler::STRTOF},
+               {"numeric", BenchFrameHandler::NUMERIC}};
+
+  printf("%-28s %10s %10s %14s %10s\n", "", "records", "numeric", "cycles/frame", "ns/frame");
+  BenchFrameHandler handler;
+  for (auto &device : DEVICES) {
+    std::string stream;
+    for (int seq = 0; seq < BLOCKS; ++seq)
+      stream += bench::text_block(device.records(seq));
+    auto records = device.records(0).size();
+    for (auto &mode : MODES) {
+      handler.mode = mode.mode;
+      uint64_t cycles = UINT64_MAX;
+      double seconds = bench::run(nullptr, [&]() {
+        handler.clear();
+        uint64_t start = bench::cycles();
+        handler.decode((uint8_t *) stream.data(), (uint8_t *) stream.data() + stream.size());
+        uint64_t elapsed = bench::cycles() - start;
+        if (elapsed < cycles)
+          cycles = elapsed;
+      });
+      if (handler.valid != BLOCKS) {
+        printf("%s: unexpected result valid=%d\n", device.name, handler.valid);
+        return 1;
+      }
+      char name[64];
+      snprintf(name, sizeof(name), "%s (%s)", device.name, mode.name);
+      printf("%-28s %10zu %10d %14.0f %10.1f\n", name, records, handler.numeric / BLOCKS, (double) cycles / BLOCKS,
+             seconds * 1e9 / BLOCKS);
+    }
+  }
+  return 0;
+}
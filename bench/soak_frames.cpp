@@ -0,0 +1,164 @@
+// Host soak harness for FrameHandler under line noise.
+// A clean stream (either synthesized - TEXT frames interleaved with HEX frames as sent by a device
+// in HEX mode - or a captured raw dump passed on the command line) is corrupted with configurable
+// bit-error and byte-drop rates and fed to the FrameHandler in UART-like chunks. For every noise
+// profile it reports the valid frames decoded per second of CPU, the frames lost per injected
+// error and the CPU cycles spent per input byte (x86 hosts only).
+//
+// build (a single command line) & run from the repository root:
+//   g++ -O2 -std=gnu++20 -Icomponents/m3_vedirect -o bench/soak_frames.out bench/soak_frames.cpp
+//     components/m3_vedirect/ve_reg_frame.cpp components/m3_vedirect/ve_reg.cpp
+//   bench/soak_frames.out [captured_stream.bin]
+#include "bench.h"
+#include "streams.h"
+
+#include "ve_reg_frame.h"
+
+#include <cmath>
+#include <fstream>
+#include <iterator>
+
+using namespace m3_ve_reg;
+
+// size of the spans fed to FrameHandler::decode (roughly what a loop iteration gets from the UART)
+static const size_t CHUNK_SIZE = 64;
+
+class SoakFrameHandler : public FrameHandler {
+ public:
+  int hex_valid{0};
+  int text_valid{0};
+  int errors{0};
+
+  void clear() {
+    this->reset();
+    this->hex_valid = this->text_valid = this->errors = 0;
+  }
+
+  void feed(const std::string &stream) {
+    auto data = (uint8_t *) stream.data();
+    auto data_end = data + stream.size();
+    for (; data < data_end; data += CHUNK_SIZE)
+      this->decode(data, data + CHUNK_SIZE < data_end ? data + CHUNK_SIZE : data_end);
+  }
+
+ private:
+#if defined(VEDIRECT_USE_HEXFRAME)
+  void on_frame_hex_(const RxHexFrame &hexframe) override { ++this->hex_valid; }
+  void on_frame_hex_error_(Error error) override { ++this->errors; }
+#endif
+#if defined(VEDIRECT_USE_TEXTFRAME)
+  void on_frame_text_(const TextFrame &textframe) override { ++this->text_valid; }
+  void on_frame_text_error_(Error error) override { ++this->errors; }
+#endif
+};
+
+// xorshift32: deterministic noise so that runs are comparable
+struct Random {
+  uint32_t state{0x12345678};
+  uint32_t next() {
+    this->state ^= this->state << 13;
+    this->state ^= this->state >> 17;
+    this->state ^= this->state << 5;
+    return this->state;
+  }
+  // true with probability 'p'
+  bool chance(double p) { return this->next() < p * 4294967296.0; }
+};
+
+/// @brief Applies line noise to 'stream': every bit is flipped with probability 'bit_error_rate'
+/// and every byte is dropped with probability 'drop_rate'.
+/// @return the corrupted stream ('events' is set to the number of corrupted/dropped bytes)
+static std::string corrupt(const std::string &stream, double bit_error_rate, double drop_rate, int &events) {
+  Random random;
+  std::string result;
+  result.reserve(stream.size());
+  // probability a byte gets at least one bit flipped
+  double byte_error_rate = 1.0 - std::pow(1.0 - bit_error_rate, 8);
+  events = 0;
+  for (char c : stream) {
+    if (drop_rate && random.chance(drop_rate)) {
+      ++events;
+      continue;
+    }
+    if (byte_error_rate && random.chance(byte_error_rate)) {
+      c ^= 1 << (random.next() & 7);
+      ++events;
+    }
+    result += c;
+  }
+  return result;
+}
+
+int main(int argc, char **argv) {
+  std::string stream;
+  if (argc > 1) {
+    std::ifstream capture(argv[1], std::ios::binary);
+    if (!capture) {
+      printf("cannot open %s\n", argv[1]);
+      return 1;
+    }
+    stream.assign(std::istreambuf_iterator<char>(capture), std::istreambuf_iterator<char>());
+  } else {
+    for (int seq = 0; seq < 500; ++seq) {
+      stream += bench::text_block(bench::mppt_records(seq));
+      stream += bench::hex_frames(seq, 4);
+    }
+  }
+
+  SoakFrameHandler handler;
+  handler.feed(stream);
+  const int frames_expected = handler.hex_valid + handler.text_valid;
+  printf("stream: %zu bytes, %d HEX frames, %d TEXT frames, %d errors\n\n", stream.size(), handler.hex_valid,
+         handler.text_valid, handler.errors);
+  if (!frames_expected)
+    return 1;
+
+  // a pure garbage stream measures the Idle (resync) scan alone
+  std::string garbage;
+  {
+    Random random;
+    for (size_t i = 0; i < stream.size(); ++i)
+      garbage += (char) random.next();
+  }
+
+  static const struct {
+    double bit_error_rate;
+    double drop_rate;
+  } PROFILES[] = {{0, 0}, {1e-6, 0}, {1e-5, 0}, {1e-4, 0}, {1e-3, 0}, {0, 1e-4}, {0, 1e-3}, {1e-4, 1e-4}, {1e-3, 1e-3}};
+
+  printf("%-10s %-10s %8s %8s %8s %10s %14s %12s %10s\n", "BER", "drop", "events", "valid", "lost", "lost/event",
+         "valid frames/s", "cycles/byte", "ns/byte");
+  for (auto &profile : PROFILES) {
+    int events;
+    std::string noisy = corrupt(stream, profile.bit_error_rate, profile.drop_rate, events);
+    uint64_t cycles = UINT64_MAX;
+    double seconds = bench::run(
+        nullptr, [&]() {
+          handler.clear();
+          uint64_t start = bench::cycles();
+          handler.feed(noisy);
+          uint64_t elapsed = bench::cycles() - start;
+          if (elapsed < cycles)
+            cycles = elapsed;
+        });
+    int valid = handler.hex_valid + handler.text_valid;
+    int lost = frames_expected - valid;
+    printf("%-10g %-10g %8d %8d %8d %10.2f %14.0f %12.2f %10.3f\n", profile.bit_error_rate, profile.drop_rate,
+           events, valid, lost, events ? (double) lost / events : 0.0, valid / seconds,
+           (double) cycles / noisy.size(), seconds * 1e9 / noisy.size());
+  }
+
+  uint64_t cycles = UINT64_MAX;
+  double seconds = bench::run(
+      nullptr, [&]() {
+        handler.clear();
+        uint64_t start = bench::cycles();
+        handler.feed(garbage);
+        uint64_t elapsed = bench::cycles() - start;
+        if (elapsed < cycles)
+          cycles = elapsed;
+      });
+  printf("%-21s %8s %8d %8s %10s %14s %12.2f %10.3f\n", "random garbage", "-", handler.hex_valid + handler.text_valid,
+         "-", "-", "-", (double) cycles / garbage.size(), seconds * 1e9 / garbage.size());
+  return 0;
+}
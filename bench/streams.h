@@ -0,0 +1,113 @@
+#pragma once
+// Synthetic VE.Direct streams shared by the host benchmarks in this folder.
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+typedef std::vector<std::pair<std::string, std::string>> text_records_t;
+
+/// @brief Builds a TEXT block (including the trailing 'Checksum' record) from a list of records
+inline std::string text_block(const text_records_t &records) {
+  std::string block;
+  for (auto &record : records) {
+    block += "\r\n";
+    block += record.first;
+    block += '\t';
+    block += record.second;
+  }
+  block += "\r\nChecksum\t";
+  uint8_t checksum = 0;
+  for (auto c : block)
+    checksum += (uint8_t) c;
+  block += (char) (uint8_t) (256 - checksum);
+  return block;
+}
+
+/// @brief Typical MPPT TEXT frame records ('seq' slightly changes some values)
+inline text_records_t mppt_records(int seq) {
+  return {{"PID", "0xA053"},
+          {"FW", "159"},
+          {"SER#", "HQ2132QY2KR"},
+          {"V", std::to_string(12800 + seq % 50)},
+          {"I", std::to_string(-150 + seq % 20)},
+          {"VPV", std::to_string(19000 + seq % 100)},
+          {"PPV", std::to_string(seq % 120)},
+          {"CS", "3"},
+          {"MPPT", "2"},
+          {"OR", "0x00000000"},
+          {"ERR", "0"},
+          {"LOAD", "ON"},
+          {"IL", "300"},
+          {"H19", "1234"},
+          {"H20", "12"},
+          {"H21", "45"},
+          {"H22", "23"},
+          {"H23", "67"},
+          {"HSDS", "42"}};
+}
+
+/// @brief Typical BMV TEXT frame records (this is usually split over 2 blocks by the device)
+inline text_records_t bmv_records(int seq) {
+  return {{"PID", "0xA381"},
+          {"V", std::to_string(12800 + seq % 50)},
+          {"VS", "12700"},
+          {"I", std::to_string(-1500 + seq % 30)},
+          {"P", std::to_string(-19 + seq % 5)},
+          {"CE", "-1234"},
+          {"SOC", "876"},
+          {"TTG", "-1"},
+          {"Alarm", "OFF"},
+          {"Relay", "OFF"},
+          {"AR", "0"},
+          {"BMV", "712 Smart"},
+          {"FW", "0413"},
+          {"MON", "0"},
+          {"H1", "-12345"},
+          {"H2", "-2345"},
+          {"H3", "-5000"},
+          {"H4", "12"},
+          {"H5", "0"},
+          {"H6", "-123456"},
+          {"H7", "11000"},
+          {"H8", "14400"},
+          {"H9", "3600"},
+          {"H10", "3"},
+          {"H11", "0"},
+          {"H12", "0"},
+          {"H15", "0"},
+          {"H16", "0"},
+          {"H17", "1234"},
+          {"H18", "1500"}};
+}
+
+/// @brief Typical (async) HEX frames as broadcasted by a device in HEX mode.
+/// Encoding is done here (not through HexFrame) so that this also works in TEXT only builds.
+inline std::string hex_frames(int seq, int count) {
+  static const char HEX_DIGITS[] = "0123456789ABCDEF";
+  std::string frames;
+  for (int i = 0; i < count; ++i) {
+    uint32_t value = seq * 7 + i * 13;
+    uint16_t register_id = 0xEDD0 + (seq + i) % 16;
+    // ASYNC command, register id, flags, 2 or 4 bytes of data
+    uint8_t raw[] = {0xA, (uint8_t) register_id, (uint8_t) (register_id >> 8), 0, (uint8_t) value,
+                     (uint8_t) (value >> 8), (uint8_t) (value >> 16), (uint8_t) (value >> 24)};
+    int raw_size = (i & 2) ? 8 : 6;
+    uint8_t checksum = 0x55 - raw[0];
+    frames += ':';
+    frames += HEX_DIGITS[raw[0]];
+    for (int j = 1; j < raw_size; ++j) {
+      frames += HEX_DIGITS[raw[j] >> 4];
+      frames += HEX_DIGITS[raw[j] & 0x0F];
+      checksum -= raw[j];
+    }
+    frames += HEX_DIGITS[checksum >> 4];
+    frames += HEX_DIGITS[checksum & 0x0F];
+    frames += '\n';
+  }
+  return frames;
+}
+
+}  // namespace bench
@@ -8,7 +8,7 @@ import esphome.codegen as cg
 from esphome.components import uart
 import esphome.config_validation as cv
 import esphome.const as ec
-from esphome.core import CORE
+from esphome.core import CORE, TimePeriod
 import esphome.cpp_generator as cpp
 
 from . import ve_reg
@@ -25,12 +25,30 @@ ENUM_DEF_LOOKUP_DEF_struct = ENUM_DEF_struct.struct("LOOKUP_DEF")
 
 m3_vedirect_ns = cg.esphome_ns.namespace("m3_vedirect")
 Manager = m3_vedirect_ns.class_("Manager", uart.UARTDevice, cg.Component)
+RequestScheduling = Manager.enum("RequestScheduling")
+REQUEST_SCHEDULING = {
+    "strict": RequestScheduling.Strict,
+    "weighted": RequestScheduling.Weighted,
+}
+RttClass = Manager.enum("RttClass")
+REQUEST_COMMAND_CLASSES = {
+    "get": RttClass.RttGet,
+    "set": RttClass.RttSet,
+    "ping": RttClass.RttPing,
+    "command": RttClass.RttCommand,
+}
 HexFrame = m3_vedirect_ns.class_("HexFrame")
 HexFrame_const_ref = HexFrame.operator("const").operator("ref")
 
 HexFrameTrigger = Manager.class_(
     "HexFrameTrigger", automation.Trigger.template(HexFrame_const_ref)
 )
+ReadTransaction = Manager.struct("ReadTransaction")
+ReadTransaction_const_ref = ReadTransaction.operator("const").operator("ref")
+ReadTransactionTrigger = Manager.class_(
+    "ReadTransactionTrigger",
+    automation.Trigger.template(cg.uint8, ReadTransaction_const_ref),
+)
 
 CONF_VEDIRECT_ID = "vedirect_id"
 CONF_VEDIRECT_ENTITIES = "vedirect_entities"
@@ -158,6 +176,9 @@ VEDIRECT_TEXTRECORD_SCHEMA = {
 
 
 # Basic schema for binary-like entities: binary_sensor, switch
+CONF_ADAPTIVE_POLLING = "adaptive_polling"
+CONF_MIN_INTERVAL = "min_interval"
+CONF_THRESHOLD = "threshold"
 CONF_MASK = "mask"
 VEDIRECT_BINARY_ENTITY_BASE_SCHEMA = {
     cv.Optional(CONF_MASK): cv.uint32_t,
@@ -298,6 +319,15 @@ class VEDirectPlatform:
                 cv.Required(CONF_REGISTER): cv.Any(
                     validate_mock_enum(ve_reg.TYPE), cv.Schema(register_schema)
                 ),
+                cv.Optional(ec.CONF_UPDATE_INTERVAL): cv.positive_not_null_time_period,
+                cv.Optional(CONF_ADAPTIVE_POLLING): cv.Schema(
+                    {
+                        cv.Required(
+                            CONF_MIN_INTERVAL
+                        ): cv.positive_not_null_time_period,
+                        cv.Optional(CONF_THRESHOLD, default=0): cv.uint32_t,
+                    }
+                ),
             },
             *vedirect_schemas,
         )
@@ -327,6 +357,12 @@ class VEDirectPlatform:
             flavors = MANAGERS_CONFIG[config[CONF_VEDIRECT_ID]][CONF_FLAVOR]
             inflated_flavors = inflate_flavors(flavors)
             for vedirect_entity_config in config[CONF_VEDIRECT_ENTITIES]:
+                if (CONF_ADAPTIVE_POLLING in vedirect_entity_config) and (
+                    ec.CONF_UPDATE_INTERVAL not in vedirect_entity_config
+                ):
+                    raise cv.Invalid(
+                        f"'{CONF_ADAPTIVE_POLLING}' needs '{ec.CONF_UPDATE_INTERVAL}' to be set"
+                    )
                 register = vedirect_entity_config[CONF_REGISTER]
                 if isinstance(register, str):
                     type_flavor = ve_reg.REG_DEFS[register].flavor
@@ -343,6 +379,18 @@ class VEDirectPlatform:
         if CONF_MASK in config:
             cg.add(reg.set_mask(config[CONF_MASK]))
 
+        if ec.CONF_UPDATE_INTERVAL in config:
+            define_use_hexframe()
+            cg.add(reg.set_update_interval(config[ec.CONF_UPDATE_INTERVAL]))
+            if CONF_ADAPTIVE_POLLING in config:
+                adaptive_config = config[CONF_ADAPTIVE_POLLING]
+                cg.add(
+                    reg.set_adaptive_polling(
+                        adaptive_config[CONF_MIN_INTERVAL],
+                        adaptive_config[CONF_THRESHOLD],
+                    )
+                )
+
         init_args = [reg]
         register_config = config[CONF_REGISTER]
         if isinstance(register_config, str):
@@ -447,8 +495,35 @@ def validate_manager(config):
 
 CONF_AUTO_CREATE_ENTITIES = "auto_create_entities"
 CONF_PING_TIMEOUT = "ping_timeout"
+CONF_TX_FRAME_GAP = "tx_frame_gap"
+CONF_TEXTFRAME_SYNC = "textframe_sync"
 CONF_FLAVOR = "flavor"
 CONF_ON_FRAME_RECEIVED = "on_frame_received"
+CONF_RX_BUDGET = "rx_budget"
+CONF_REQUEST_SCHEDULING = "request_scheduling"
+CONF_PIPELINE_WINDOW = "pipeline_window"
+CONF_POLLING_BUDGET = "polling_budget"
+CONF_FRESHNESS_TTL = "freshness_ttl"
+CONF_REQUEST_TIMEOUT_MIN = "request_timeout_min"
+CONF_REQUEST_TIMEOUT_MAX = "request_timeout_max"
+CONF_STALE_TIMEOUT = "stale_timeout"
+CONF_PROCEDURES = "procedures"
+CONF_POOL_SIZE = "pool_size"
+CONF_FRAME_SIZE = "frame_size"
+CONF_RETRY_POLICY = "retry_policy"
+CONF_MAX_ATTEMPTS = "max_attempts"
+CONF_BACKOFF = "backoff"
+CONF_PRIORITY = "priority"
+RETRY_POLICY_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_MAX_ATTEMPTS, default=3): cv.int_range(min=1, max=15),
+        cv.Optional(CONF_BACKOFF, default="0ms"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(max=TimePeriod(milliseconds=10000)),
+        ),
+        cv.Optional(CONF_PRIORITY, default=True): cv.boolean,
+    }
+)
 CONFIG_SCHEMA = (
     cv.Schema(
         {
@@ -457,6 +532,8 @@ CONFIG_SCHEMA = (
             cv.Optional(
                 CONF_FLAVOR, default=[flavor.name for flavor in ve_reg.Flavor]
             ): cv.ensure_list(validate_str_enum(ve_reg.Flavor)),
+            cv.Optional(CONF_RX_BUDGET): cv.positive_int,
+            cv.Optional(CONF_STALE_TIMEOUT): cv.positive_time_period_milliseconds,
             cv.Optional(CONF_TEXTFRAME): cv.Schema(
                 {
                     cv.Optional(CONF_AUTO_CREATE_ENTITIES): cv.boolean,
@@ -466,6 +543,43 @@ CONFIG_SCHEMA = (
                 {
                     cv.Optional(CONF_AUTO_CREATE_ENTITIES): cv.boolean,
                     cv.Optional(CONF_PING_TIMEOUT): cv.positive_time_period_seconds,
+                    cv.Optional(
+                        CONF_TX_FRAME_GAP
+                    ): cv.positive_time_period_milliseconds,
+                    cv.Optional(CONF_TEXTFRAME_SYNC): cv.boolean,
+                    cv.Optional(CONF_REQUEST_SCHEDULING): cv.enum(
+                        REQUEST_SCHEDULING, lower=True
+                    ),
+                    cv.Optional(CONF_PIPELINE_WINDOW): cv.int_range(min=1, max=16),
+                    cv.Optional(CONF_POLLING_BUDGET): cv.positive_int,
+                    cv.Optional(
+                        CONF_FRESHNESS_TTL
+                    ): cv.positive_time_period_milliseconds,
+                    # Request::timeout is 16 bits (millis)
+                    cv.Optional(CONF_REQUEST_TIMEOUT_MIN): cv.All(
+                        cv.positive_time_period_milliseconds,
+                        cv.Range(max=TimePeriod(milliseconds=65535)),
+                    ),
+                    cv.Optional(CONF_REQUEST_TIMEOUT_MAX): cv.All(
+                        cv.positive_not_null_time_period,
+                        cv.Range(max=TimePeriod(milliseconds=65535)),
+                    ),
+                    cv.Optional(CONF_PROCEDURES): cv.Schema(
+                        {
+                            cv.Optional(CONF_POOL_SIZE, default=2): cv.int_range(
+                                min=1, max=16
+                            ),
+                            cv.Optional(CONF_FRAME_SIZE, default=256): cv.int_range(
+                                min=64, max=4096
+                            ),
+                        }
+                    ),
+                    cv.Optional(CONF_RETRY_POLICY): cv.Schema(
+                        {
+                            cv.Optional(command_class): RETRY_POLICY_SCHEMA
+                            for command_class in REQUEST_COMMAND_CLASSES
+                        }
+                    ),
                     cv.Optional(CONF_ON_FRAME_RECEIVED): automation.validate_automation(
                         {
                             cv.GenerateID(ec.CONF_TRIGGER_ID): cv.declare_id(
@@ -504,6 +618,10 @@ async def to_code(config: dict):
         cg.add(var.set_vedirect_name(config[ec.CONF_NAME]))
     for flavor in deflate_flavors(config[CONF_FLAVOR]):
         cg.add_build_flag(f"-DVEDIRECT_FLAVOR_{flavor}")
+    if CONF_RX_BUDGET in config:
+        cg.add(var.set_rx_budget(config[CONF_RX_BUDGET]))
+    if CONF_STALE_TIMEOUT in config:
+        cg.add(var.set_stale_timeout(config[CONF_STALE_TIMEOUT]))
     if CONF_TEXTFRAME in config:
         define_use_textframe()
         config_textframe = config[CONF_TEXTFRAME]
@@ -524,6 +642,53 @@ async def to_code(config: dict):
             )
         if CONF_PING_TIMEOUT in config_hexframe:
             cg.add(var.set_ping_timeout(config_hexframe[CONF_PING_TIMEOUT]))
+        if CONF_TX_FRAME_GAP in config_hexframe:
+            cg.add(var.set_tx_frame_gap(config_hexframe[CONF_TX_FRAME_GAP]))
+        if CONF_TEXTFRAME_SYNC in config_hexframe:
+            # the TEXT frames cadence is only tracked when parsing them
+            define_use_textframe()
+            cg.add(var.set_textframe_sync(config_hexframe[CONF_TEXTFRAME_SYNC]))
+        if CONF_REQUEST_SCHEDULING in config_hexframe:
+            cg.add(
+                var.set_request_scheduling(config_hexframe[CONF_REQUEST_SCHEDULING])
+            )
+        if CONF_PIPELINE_WINDOW in config_hexframe:
+            cg.add(var.set_pipeline_window(config_hexframe[CONF_PIPELINE_WINDOW]))
+        if CONF_POLLING_BUDGET in config_hexframe:
+            cg.add(var.set_polling_budget(config_hexframe[CONF_POLLING_BUDGET]))
+        if CONF_FRESHNESS_TTL in config_hexframe:
+            cg.add(var.set_freshness_ttl(config_hexframe[CONF_FRESHNESS_TTL]))
+        if CONF_REQUEST_TIMEOUT_MIN in config_hexframe:
+            cg.add(
+                var.set_request_timeout_min(config_hexframe[CONF_REQUEST_TIMEOUT_MIN])
+            )
+        if CONF_REQUEST_TIMEOUT_MAX in config_hexframe:
+            cg.add(
+                var.set_request_timeout_max(config_hexframe[CONF_REQUEST_TIMEOUT_MAX])
+            )
+        if CONF_PROCEDURES in config_hexframe:
+            config_procedures = config_hexframe[CONF_PROCEDURES]
+            # these are needed by the compilation units (not only by the ones including esphome/defines.h)
+            cg.add_build_flag(
+                f"-DVEDIRECT_PROCEDURE_POOL_SIZE={config_procedures[CONF_POOL_SIZE]}"
+            )
+            cg.add_build_flag(
+                f"-DVEDIRECT_PROCEDURE_FRAME_SIZE={config_procedures[CONF_FRAME_SIZE]}"
+            )
+            if CORE.is_esp8266:
+                # xtensa gcc 10 needs coroutines explicitly enabled
+                cg.add_build_flag("-fcoroutines")
+        for command_class, retry_policy in config_hexframe.get(
+            CONF_RETRY_POLICY, {}
+        ).items():
+            cg.add(
+                var.set_retry_policy(
+                    REQUEST_COMMAND_CLASSES[command_class],
+                    retry_policy[CONF_MAX_ATTEMPTS],
+                    retry_policy[CONF_BACKOFF],
+                    retry_policy[CONF_PRIORITY],
+                )
+            )
 
         for conf in config_hexframe.get(CONF_ON_FRAME_RECEIVED, []):
             trigger = cg.new_Pvariable(conf[ec.CONF_TRIGGER_ID], var)
@@ -537,9 +702,32 @@ async def to_code(config: dict):
 
 # ACTIONS
 
+def validate_hexframe(value):
+    """Validates a raw HEX frame payload (as accepted by Manager::send_hexframe) and
+    returns the full encoded frame (':' + payload + checksum + '\\n') so that constant
+    frames are sent as they are without runtime parsing/checksumming."""
+    value = cv.string_strict(value)
+    checksum_included = value.endswith("\n")
+    digits = value[:-1] if checksum_included else value
+    if not digits or any(c not in "0123456789ABCDEF" for c in digits):
+        raise cv.Invalid(f"Invalid HEX frame '{value}' (uppercase hex digits expected)")
+    if not (len(digits) % 2):
+        raise cv.Invalid(f"Invalid HEX frame '{value}' (odd number of hex digits expected)")
+    checksum = 0x55 - int(digits[0], 16)
+    for i in range(1, len(digits), 2):
+        checksum -= int(digits[i : i + 2], 16)
+    checksum &= 0xFF
+    if checksum_included:
+        if checksum:
+            raise cv.Invalid(f"Invalid HEX frame '{value}' (checksum error)")
+        return f":{digits}\n"
+    return f":{digits}{checksum:02X}\n"
+
+
 _CTYPE_VALIDATOR_MAP = {
     cv.string: cg.std_string,
     cv.int_: cg.int_,
+    validate_hexframe: cg.std_string,
     validate_register_id: cg.uint16,
 }
 
@@ -553,6 +741,11 @@ async def action_to_code(
     for _schema_key, _ctype in schema_def.items():
         _key_name = _schema_key.schema
         if _key_name in config:
+            if (_ctype is validate_hexframe) and not cg.is_template(config[_key_name]):
+                # precompiled (encoded and checksummed) frame
+                _frame = config[_key_name]
+                cg.add(var.set_frame(_frame, len(_frame)))
+                continue
             template_ = await cg.templatable(
                 config[_key_name], args, _CTYPE_VALIDATOR_MAP[_ctype]
             )
@@ -566,7 +759,7 @@ CONF_DATA_SIZE = "data_size"
 MANAGER_ACTIONS = {
     "send_hexframe": {
         cv.Optional(CONF_VEDIRECT_ID, default=""): cv.string,
-        cv.Required(ec.CONF_DATA): cv.string,
+        cv.Required(ec.CONF_DATA): validate_hexframe,
     },
     "send_command": {
         cv.Optional(CONF_VEDIRECT_ID, default=""): cv.string,
@@ -588,3 +781,44 @@ for _action_name, _schema_def in MANAGER_ACTIONS.items():
     automation.register_action(f"m3_vedirect.{_action_name}", _action, _schema)(
         partial(action_to_code, _schema_def)
     )
+
+
+CONF_REGISTER_IDS = "register_ids"
+CONF_ON_COMPLETE = "on_complete"
+Action_read_registers = Manager.class_("Action_read_registers", automation.Action)
+
+
+@automation.register_action(
+    "m3_vedirect.read_registers",
+    Action_read_registers,
+    cv.Schema(
+        {
+            cv.Optional(CONF_VEDIRECT_ID, default=""): cv.templatable(cv.string),
+            cv.Required(CONF_REGISTER_IDS): cv.All(
+                cv.ensure_list(validate_register_id()), cv.Length(min=1, max=255)
+            ),
+            cv.Optional(CONF_ON_COMPLETE): automation.validate_automation(
+                {
+                    cv.GenerateID(ec.CONF_TRIGGER_ID): cv.declare_id(
+                        ReadTransactionTrigger
+                    ),
+                }
+            ),
+        }
+    ),
+)
+async def read_registers_to_code(config, action_id, template_args, args):
+    define_use_hexframe()
+    var = cg.new_Pvariable(action_id, template_args)
+    template_ = await cg.templatable(config[CONF_VEDIRECT_ID], args, cg.std_string)
+    cg.add(var.set_vedirect_id(template_))
+    cg.add(var.set_register_ids(config[CONF_REGISTER_IDS]))
+    for conf in config.get(CONF_ON_COMPLETE, []):
+        trigger = cg.new_Pvariable(conf[ec.CONF_TRIGGER_ID])
+        cg.add(var.set_on_complete(trigger))
+        await automation.build_automation(
+            trigger,
+            [(cg.uint8, "failed"), (ReadTransaction_const_ref, "transaction")],
+            conf,
+        )
+    return var
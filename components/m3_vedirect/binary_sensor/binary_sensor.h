@@ -46,9 +46,9 @@ class BinarySensor final : public Register, public esphome::binary_sensor::Binar
   static void parse_hex_enum_(Register *hex_register, const RxHexFrame *hex_frame);
 #endif
 #if defined(VEDIRECT_USE_TEXTFRAME)
-  static void parse_text_default_(Register *hex_register, const char *text_value);
-  static void parse_text_bitmask_(Register *hex_register, const char *text_value);
-  static void parse_text_enum_(Register *hex_register, const char *text_value);
+  static void parse_text_default_(Register *hex_register, const TextRecord &text_record, const char *text_value);
+  static void parse_text_bitmask_(Register *hex_register, const TextRecord &text_record, const char *text_value);
+  static void parse_text_enum_(Register *hex_register, const TextRecord &text_record, const char *text_value);
 #endif
 };
 
@@ -2,7 +2,10 @@
 
 #include <cstddef>
 #include <cmath>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 namespace esphome {
 namespace m3_vedirect {
@@ -25,6 +28,41 @@ template<typename TKey> struct compare_default {
   constexpr int operator()(TKey key_low, TKey key_high) const { return key_high - key_low; }
 };
 
+/// @brief Fixed capacity replacement for std::function which never allocates.
+/// The callable is stored inline so that it must fit in Capacity bytes and be trivially
+/// copyable/destructible (i.e. lambdas capturing a few pointers or plain values). This, in turn,
+/// keeps the Delegate itself trivially copyable and cheap to move around.
+template<typename Signature, size_t Capacity = 2 * sizeof(void *)> class Delegate;
+template<typename R, typename... Args, size_t Capacity> class Delegate<R(Args...), Capacity> {
+ public:
+  constexpr Delegate() = default;
+  constexpr Delegate(std::nullptr_t) {}
+  template<typename F, typename = typename std::enable_if<
+                           !std::is_same<typename std::decay<F>::type, Delegate>::value>::type>
+  Delegate(F &&callable) {
+    typedef typename std::decay<F>::type callable_t;
+    static_assert(sizeof(callable_t) <= Capacity, "Delegate: callable exceeds the inline storage capacity");
+    static_assert(alignof(callable_t) <= alignof(void *), "Delegate: callable alignment not supported");
+    static_assert(std::is_trivially_copyable<callable_t>::value && std::is_trivially_destructible<callable_t>::value,
+                  "Delegate: callable must be trivially copyable and destructible");
+    new (this->storage_) callable_t(std::forward<F>(callable));
+    this->invoke_ = [](void *storage, Args... args) -> R {
+      return (*static_cast<callable_t *>(storage))(std::forward<Args>(args)...);
+    };
+  }
+  Delegate &operator=(std::nullptr_t) {
+    this->invoke_ = nullptr;
+    return *this;
+  }
+
+  explicit operator bool() const { return this->invoke_ != nullptr; }
+  R operator()(Args... args) const { return this->invoke_(this->storage_, std::forward<Args>(args)...); }
+
+ protected:
+  R (*invoke_)(void *, Args...){nullptr};
+  alignas(void *) mutable unsigned char storage_[Capacity]{};
+};
+
 /// @brief A bucket for holding registers with the same hash (see TinyMap).
 /// This abstract class provides the interface for a bucket implementation.
 template<typename TKey, typename TValue, typename TBucket> class Bucket {
@@ -238,8 +276,11 @@ class TinyMap {
     this->size_ = 0;
   }
 
-  bucket_type *find(TKey key) const {
-    for (auto bucket = this->buckets_[hash(key)]; bucket; bucket = bucket->bucket_next_) {
+  bucket_type *find(TKey key) const { return this->find(key, THash()(key)); }
+
+  /// @brief Same as find(key) when the (unmasked) hash of the key is already known.
+  bucket_type *find(TKey key, size_t key_hash) const {
+    for (auto bucket = this->buckets_[key_hash & (MAP_SIZE - 1)]; bucket; bucket = bucket->bucket_next_) {
       auto cmp = compare(key, bucket->bucket_key_);
       if (cmp == 0) {
         return bucket;
@@ -19,12 +19,69 @@ class Register;
 #define VEDIRECT_LINK_TIMEOUT_MILLIS 5000
 
 // maximum amount of time (millis) without receiving a SET command
-// reply after which we consider the command unsuccesful
+// reply after which we consider the command unsuccesful.
+// This is the upper bound (and initial value) of the adaptive request timeouts
+// which are estimated from the measured round trip times (see Manager::set_request_timeout).
+#ifndef VEDIRECT_COMMAND_TIMEOUT_MILLIS
 #define VEDIRECT_COMMAND_TIMEOUT_MILLIS 1000
+#endif
+// lower bound (millis) of the adaptive request timeouts
+#ifndef VEDIRECT_COMMAND_TIMEOUT_MIN_MILLIS
+#define VEDIRECT_COMMAND_TIMEOUT_MIN_MILLIS 100
+#endif
+
+// size (bytes - must be a power of 2) of the ring buffer used to ingest data from the UART
+#ifndef VEDIRECT_RX_BUFFER_SIZE
+#define VEDIRECT_RX_BUFFER_SIZE 512
+#endif
+
+// size (bytes - must be a power of 2) of the ring buffer queueing the outgoing HEX frames
+// which are then written to the UART from Manager::loop (see Manager::set_tx_frame_gap)
+#ifndef VEDIRECT_TX_BUFFER_SIZE
+#define VEDIRECT_TX_BUFFER_SIZE 128
+#endif
 
-// maximum number of pending requests (GET/SET/COMMAND) we can queue/track
+// C++20 coroutines based procedures (see procedure.h): maximum number of procedures alive at the
+// same time and maximum size (bytes) of their coroutine frame. 0 disables the feature.
+#ifndef VEDIRECT_PROCEDURE_POOL_SIZE
+#define VEDIRECT_PROCEDURE_POOL_SIZE 0
+#endif
+#ifndef VEDIRECT_PROCEDURE_FRAME_SIZE
+#define VEDIRECT_PROCEDURE_FRAME_SIZE 256
+#endif
+
+// maximum number of pending requests (GET/SET/COMMAND) we can queue/track.
+// The slots are shared among the request classes (see Manager::RequestClass) and
+// a request coalesced into a pending one takes a slot too (when carrying a callback)
 #ifndef VEDIRECT_REQUEST_QUEUE_SIZE
-#define VEDIRECT_REQUEST_QUEUE_SIZE 5
+#define VEDIRECT_REQUEST_QUEUE_SIZE 16
+#endif
+
+// Periodic polling timer wheel: registers with an 'update_interval' are hashed into
+// VEDIRECT_POLL_WHEEL_SIZE slots by their due time in VEDIRECT_POLL_WHEEL_TICK_MILLIS units.
+// Both must be powers of 2 so that slot indexing stays continuous across millis() wraparound.
+#ifndef VEDIRECT_POLL_WHEEL_SIZE
+#define VEDIRECT_POLL_WHEEL_SIZE 32
+#endif
+#ifndef VEDIRECT_POLL_WHEEL_TICK_MILLIS
+#define VEDIRECT_POLL_WHEEL_TICK_MILLIS 256
+#endif
+
+// default freshness (millis): registers updated (TEXT record, HEX async or reply) more recently
+// than this are skipped by polling (see Manager::set_freshness_ttl)
+#ifndef VEDIRECT_FRESHNESS_TTL_MILLIS
+#define VEDIRECT_FRESHNESS_TTL_MILLIS 2000
+#endif
+
+// period (millis) of the scan for stale registers (see Manager::set_stale_timeout)
+#ifndef VEDIRECT_STALE_CHECK_MILLIS
+#define VEDIRECT_STALE_CHECK_MILLIS 1000
+#endif
+
+// period (millis) of the publishing of the requests diagnostic sensors (percentiles are computed
+// over the requests completed in the period)
+#ifndef VEDIRECT_STATS_PUBLISH_MILLIS
+#define VEDIRECT_STATS_PUBLISH_MILLIS 60000
 #endif
 
 // number of pre-allocated buckets in HEX registers map (see HexRegisterMap)
@@ -37,5 +94,26 @@ class Register;
 #define VEDIRECT_TEXTMAP_SIZE 16
 #endif
 
+// maximum number of records tracked in a TEXT frame 'shape' (the ordered sequence of
+// the bound registers - see Manager::on_frame_text_name_)
+#ifndef VEDIRECT_TEXT_SHAPE_SIZE
+#define VEDIRECT_TEXT_SHAPE_SIZE 24
+#endif
+
+// TEXT frames cadence tracking (see Manager::set_textframe_sync): TEXT frames starting less than
+// VEDIRECT_TEXT_BURST_GAP_MILLIS after the end of the previous one belong to the same 'burst' (some
+// devices send more blocks back to back). HEX requests whose reply (estimated from the round trip time)
+// would be due less than VEDIRECT_TEXT_GUARD_MILLIS before the next predicted burst are held back
+// until it ends. The prediction is used once VEDIRECT_TEXT_CADENCE_SAMPLES consistent periods were measured.
+#ifndef VEDIRECT_TEXT_BURST_GAP_MILLIS
+#define VEDIRECT_TEXT_BURST_GAP_MILLIS 50
+#endif
+#ifndef VEDIRECT_TEXT_GUARD_MILLIS
+#define VEDIRECT_TEXT_GUARD_MILLIS 20
+#endif
+#ifndef VEDIRECT_TEXT_CADENCE_SAMPLES
+#define VEDIRECT_TEXT_CADENCE_SAMPLES 3
+#endif
+
 }  // namespace m3_vedirect
 }  // namespace esphome
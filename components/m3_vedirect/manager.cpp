@@ -15,6 +15,11 @@ const char *FRAME_ERRORS[Manager::Error::_COUNT] = {"None",          "Checksum",
                                                     "Timeout",       "Unexpected",     "Remote",          "Flags",
                                                     "Queue full"};
 
+#if defined(VEDIRECT_USE_HEXFRAME)
+// encoded at compile time (":154\n")
+static constexpr HexFrameConstT<0> PING_FRAME(HEXFRAME::COMMAND::Ping);
+#endif
+
 Manager *Manager::list_ = nullptr;
 
 Manager::StaticIterator::StaticIterator(const std::string &vedirect_id_key) {
@@ -57,22 +62,50 @@ void Manager::setup() {
   }
 #if defined(VEDIRECT_USE_HEXFRAME)
   this->last_ping_tx_ = -this->ping_timeout_;
+
+  // Periodic polling setup: registers sharing the same update_interval are evenly
+  // spread over the period so that their requests don't burst on the same tick.
+  const uint32_t now = millis();
+  this->poll_wheel_time_ = now & ~(VEDIRECT_POLL_WHEEL_TICK_MILLIS - 1);
+  for (auto it = this->hex_registers_.begin(); !it.is_end(); ++it) {
+    if (!it->polling_)
+      continue;
+    auto update_interval = it->polling_->interval;
+    uint32_t phase = 0, phases = 0;
+    for (auto it_same = this->hex_registers_.begin(); !it_same.is_end(); ++it_same) {
+      if (it_same->polling_ && (it_same->polling_->interval == update_interval)) {
+        if (it_same == it)
+          phase = phases;
+        ++phases;
+      }
+    }
+    this->poll_schedule_(&*it, now + update_interval + (update_interval / phases) * phase);
+    this->poll_load_ += 1000000 / update_interval;
+    ++this->poll_wheel_size_;
+  }
+  this->poll_tokens_ = this->poll_budget_ * 1000;
+  this->poll_tokens_time_ = now;
 #endif
 }
 
 void Manager::loop() {
-  const int millis_ = millis();
-  auto available = this->available();
-  if (available) {
-    uint8_t frame_buf[256];
-    if (available > sizeof(frame_buf))
-      available = sizeof(frame_buf);
-    this->read_array(frame_buf, available);
+  // unsigned arithmetic so that elapsed times are correct across millis() wraparound
+  const uint32_t millis_ = millis();
+  if (this->rx_ingest_())
     this->last_rx_ = millis_;
-    this->decode(frame_buf, frame_buf + available);
+  if (this->rx_head_ != this->rx_tail_) {
+    this->rx_decode_();
+    // without an rx_budget_ the ring is empty now: keep on ingesting/decoding in case the uart
+    // had more than VEDIRECT_RX_BUFFER_SIZE bytes pending
+    while (!this->rx_budget_ && this->rx_ingest_())
+      this->rx_decode_();
+#if defined(VEDIRECT_USE_HEXFRAME) && defined(VEDIRECT_USE_TEXTFRAME)
+    if (!this->textframe_receiving_ && this->is_textframe_in_progress())
+      this->textframe_begin_(millis_);
+#endif
 
 #if defined(VEDIRECT_USE_HEXFRAME)
-    if (this->ping_timeout_ && ((millis_ - this->last_ping_tx_) > this->ping_timeout_)) {
+    if (this->ping_timeout_ && ((millis_ - this->last_ping_tx_) > (uint32_t) this->ping_timeout_)) {
       this->request_command(HEXFRAME::COMMAND::Ping);
       this->last_ping_tx_ = millis_;
     }
@@ -82,18 +115,302 @@ void Manager::loop() {
       this->on_disconnected_();
     }
   }
+  if (this->stale_timeout_ && this->connected_ && ((int32_t) (millis_ - this->stale_check_time_) >= 0)) {
+    this->stale_check_time_ = millis_ + VEDIRECT_STALE_CHECK_MILLIS;
+    this->check_stale_(millis_);
+  }
 
 #if defined(VEDIRECT_USE_HEXFRAME)
-  // Checking requests timeouts
-  if (auto request = this->requests_read_) {
-    if (request->timeout < millis_) {
-      this->request_response_(request, nullptr, Error::TIMEOUT);
+  // Checking requests timeouts (in-flight requests are ordered by timeout)
+  for (Request *request;
+       (request = this->requests_read_) && request->sent && ((millis_ - request->time) > request->timeout);) {
+#if defined(VEDIRECT_USE_TEXTFRAME)
+    if (this->is_textframe_in_progress()) {
+      // the reply will only come after the TEXT frame: postpone every in-flight request
+      // by a whole timeout from now (keeping the ordering)
+      uint32_t deadline = millis_ + this->get_request_timeout(rtt_class_(request->command));
+      for (; request; request = request->next) {
+        int32_t delay = deadline - request->deadline();
+        if (delay > 0)
+          request->timeout = std::min<uint32_t>(request->timeout + delay, UINT16_MAX);
+      }
+      break;
     }
+#endif
+    this->request_response_(request, nullptr, Error::TIMEOUT);
+  }
+  if (this->requests_retry_ && ((int32_t) (millis_ - this->requests_retry_->time) >= 0)) {
+    this->request_retry_(millis_);
+    this->request_dispatch_();
+  }
+#if defined(VEDIRECT_USE_TEXTFRAME)
+  if (this->requests_held_ && ((int32_t) (millis_ - this->requests_hold_until_) >= 0)) {
+    this->requests_held_ = false;
+    this->request_dispatch_();
+  }
+#endif
+#if VEDIRECT_PROCEDURE_POOL_SIZE
+  Procedure::resume_(this, millis_);
+#endif
+  if (this->poll_wheel_size_ && ((int32_t) (millis_ - this->poll_wheel_time_) >= 0)) {
+    this->poll_wheel_tick_(millis_);
+  }
+#ifdef USE_SENSOR
+  if ((int32_t) (millis_ - this->request_stats_publish_time_) >= 0) {
+    this->request_stats_publish_(millis_);
+  }
+#endif
+  // last so that the frames queued in this iteration are sent right away
+  if (this->tx_head_ != this->tx_tail_) {
+    this->tx_flush_(millis_);
+    if (this->requests_tx_held_)
+      this->request_dispatch_();
   }
 #endif
 }
 
+/// @brief Drains the UART into the ring buffer (as long as there's room)
+/// @return true if any new data was received
+bool Manager::rx_ingest_() {
+  uint32_t rx_head = this->rx_head_;
+  int available;
+  while ((available = this->available()) > 0) {
+    uint32_t rx_free = VEDIRECT_RX_BUFFER_SIZE - (rx_head - this->rx_tail_);
+    if (!rx_free) {
+      // with an rx_budget_ the UART FIFO will keep on filling (and likely overflow) until a later
+      // loop decodes some data. Otherwise loop() decodes and drains again right away.
+      if (this->rx_budget_)
+        ++this->rx_overruns_;
+      break;
+    }
+    // contiguous room up to the end of the ring
+    uint32_t index = rx_head & (VEDIRECT_RX_BUFFER_SIZE - 1);
+    uint32_t span = VEDIRECT_RX_BUFFER_SIZE - index;
+    if (span > rx_free)
+      span = rx_free;
+    if (span > (uint32_t) available)
+      span = available;
+    this->read_array(this->rx_buffer_ + index, span);
+    rx_head += span;
+  }
+  if (rx_head == this->rx_head_)
+    return false;
+  this->rx_head_ = rx_head;
+  uint32_t rx_queued = rx_head - this->rx_tail_;
+  if (rx_queued > this->rx_high_water_mark_)
+    this->rx_high_water_mark_ = rx_queued;
+  return true;
+}
+
+/// @brief Feeds the FrameHandler with (contiguous spans of) the data queued in the ring buffer
+/// up to the configured rx_budget_
+void Manager::rx_decode_() {
+  uint32_t rx_queued = this->rx_head_ - this->rx_tail_;
+  if (this->rx_budget_ && (rx_queued > this->rx_budget_))
+    rx_queued = this->rx_budget_;
+  while (rx_queued) {
+    uint32_t index = this->rx_tail_ & (VEDIRECT_RX_BUFFER_SIZE - 1);
+    uint32_t span = VEDIRECT_RX_BUFFER_SIZE - index;
+    if (span > rx_queued)
+      span = rx_queued;
+    this->rx_tail_ += span;
+    rx_queued -= span;
+    this->decode(this->rx_buffer_ + index, this->rx_buffer_ + index + span);
+  }
+}
+
+#if defined(VEDIRECT_USE_HEXFRAME)
+bool Manager::tx_push_(const char *encoded, size_t encoded_size) {
+  // tx_flush_ relies on every queued frame being ':'...'\n' (with no '\n' inside)
+  if ((encoded_size < 2) || (encoded[0] != ':') || (encoded[encoded_size - 1] != '\n') ||
+      memchr(encoded, '\n', encoded_size - 1)) {
+    ESP_LOGE(this->logtag_, "HEX FRAME: malformed frame (size=%u) not queued", (unsigned) encoded_size);
+    return false;
+  }
+  uint32_t tx_head = this->tx_head_;
+  if ((VEDIRECT_TX_BUFFER_SIZE - (tx_head - this->tx_tail_)) < encoded_size) {
+    this->tx_dropped_ += encoded_size;
+    return false;
+  }
+  uint32_t index = tx_head & (VEDIRECT_TX_BUFFER_SIZE - 1);
+  uint32_t span = VEDIRECT_TX_BUFFER_SIZE - index;
+  if (span >= encoded_size) {
+    memcpy(this->tx_buffer_ + index, encoded, encoded_size);
+  } else {
+    memcpy(this->tx_buffer_ + index, encoded, span);
+    memcpy(this->tx_buffer_, encoded + span, encoded_size - span);
+  }
+  this->tx_head_ = tx_head + encoded_size;
+  return true;
+}
+
+bool Manager::tx_push_command_(HEXFRAME::COMMAND command, register_id_t register_id, const uint8_t *data,
+                               size_t data_size) {
+  // :[COMMAND][REGISTER_ID][FLAGS][DATA][CHECKSUM]\n
+  const size_t encoded_size = 1 + 1 + (2 + 1 + data_size) * 2 + 2 + 1;
+  uint32_t tx_head = this->tx_head_;
+  if ((VEDIRECT_TX_BUFFER_SIZE - (tx_head - this->tx_tail_)) < encoded_size) {
+    this->tx_dropped_ += encoded_size;
+    return false;
+  }
+  // the ring index is masked on every char so that the frame can wrap anywhere
+  auto tx_buffer = this->tx_buffer_;
+  uint8_t checksum = 0x55 - command;
+  auto push = [tx_buffer, &tx_head, &checksum](uint8_t byte) {
+    checksum -= byte;
+    tx_buffer[tx_head++ & (VEDIRECT_TX_BUFFER_SIZE - 1)] = HEX_DIGITS_MAP[byte >> 4];
+    tx_buffer[tx_head++ & (VEDIRECT_TX_BUFFER_SIZE - 1)] = HEX_DIGITS_MAP[byte & 0x0F];
+  };
+  tx_buffer[tx_head++ & (VEDIRECT_TX_BUFFER_SIZE - 1)] = ':';
+  tx_buffer[tx_head++ & (VEDIRECT_TX_BUFFER_SIZE - 1)] = HEX_DIGITS_MAP[command & 0x0F];
+  push(register_id & 0xFF);
+  push(register_id >> 8);
+  push(0);  // flags
+  for (size_t i = 0; i < data_size; ++i)
+    push(data[i]);
+  tx_buffer[tx_head++ & (VEDIRECT_TX_BUFFER_SIZE - 1)] = HEX_DIGITS_MAP[checksum >> 4];
+  tx_buffer[tx_head++ & (VEDIRECT_TX_BUFFER_SIZE - 1)] = HEX_DIGITS_MAP[checksum & 0x0F];
+  tx_buffer[tx_head++ & (VEDIRECT_TX_BUFFER_SIZE - 1)] = '\n';
+  this->tx_head_ = tx_head;
+  return true;
+}
+
+void Manager::tx_flush_(uint32_t now) {
+  uint32_t tx_tail = this->tx_tail_;
+  while (tx_tail != this->tx_head_) {
+    if (this->tx_frame_gap_) {
+      if ((now - this->tx_last_) < this->tx_frame_gap_)
+        break;
+      this->tx_last_ = now;
+    }
+    // a whole frame (up to and including its '\n') at a time
+    uint32_t index = tx_tail & (VEDIRECT_TX_BUFFER_SIZE - 1);
+    uint32_t span = VEDIRECT_TX_BUFFER_SIZE - index;
+    if (span > (this->tx_head_ - tx_tail))
+      span = this->tx_head_ - tx_tail;
+    auto frame_begin = this->tx_buffer_ + index;
+    if (auto frame_end = (char *) memchr(frame_begin, '\n', span)) {
+      span = frame_end + 1 - frame_begin;
+      this->write_array((const uint8_t *) frame_begin, span);
+      ESP_LOGV(this->logtag_, "HEX FRAME: sent %.*s", (int) span - 1, frame_begin);
+    } else {
+      // the frame wraps around the end of the ring
+      this->write_array((const uint8_t *) frame_begin, span);
+      frame_end = (char *) memchr(this->tx_buffer_, '\n', this->tx_head_ - tx_tail - span);
+      this->write_array((const uint8_t *) this->tx_buffer_, frame_end + 1 - this->tx_buffer_);
+      ESP_LOGV(this->logtag_, "HEX FRAME: sent %.*s%.*s", (int) span, frame_begin,
+               (int) (frame_end - this->tx_buffer_), this->tx_buffer_);
+      span += frame_end + 1 - this->tx_buffer_;
+    }
+    tx_tail += span;
+  }
+  if (tx_tail == this->tx_tail_)
+    return;
+  this->tx_tail_ = tx_tail;
+  // in-flight requests are in the same order as their frames in the ring
+  Request *prev = nullptr;
+  for (auto request = this->requests_read_; request; prev = request, request = request->next) {
+    if (request->sent)
+      continue;
+    if ((int16_t) (request->tx_end - (uint16_t) tx_tail) > 0)
+      break;
+    request->sent = true;
+    request->queue_wait = std::min<uint32_t>(request->queue_wait + (now - request->time), UINT16_MAX);
+    request->time = now;
+    if (prev) {
+      // the estimate could have shrunk since the previous request was sent: keep the list ordered by timeout
+      int32_t delay = prev->deadline() - request->deadline();
+      if (delay > 0)
+        request->timeout = std::min<uint32_t>(request->timeout + delay, UINT16_MAX);
+    }
+  }
+}
+#endif  // defined(VEDIRECT_USE_HEXFRAME)
+
 void Manager::dump_config() {
+  ESP_LOGCONFIG(this->logtag_, "RX buffer: size=%u, budget=%u, high_water_mark=%u, overruns=%u",
+                (unsigned) VEDIRECT_RX_BUFFER_SIZE, (unsigned) this->rx_budget_, (unsigned) this->rx_high_water_mark_,
+                (unsigned) this->rx_overruns_);
+#if defined(VEDIRECT_USE_HEXFRAME)
+  ESP_LOGCONFIG(this->logtag_, "TX buffer: size=%u, frame gap=%u ms, queued=%u, sent=%u, dropped=%u bytes",
+                (unsigned) VEDIRECT_TX_BUFFER_SIZE, (unsigned) this->tx_frame_gap_, (unsigned) this->tx_head_,
+                (unsigned) this->tx_tail_, (unsigned) this->tx_dropped_);
+#endif
+  auto &dispatch_stats = this->dispatch_stats_;
+  ESP_LOGCONFIG(this->logtag_, "Dispatch cache hits: HEX=%u/%u, TEXT=%u/%u, TEXT frames=%u/%u, TEXT shape=%u/%u",
+                (unsigned) dispatch_stats.hex_hits, (unsigned) (dispatch_stats.hex_hits + dispatch_stats.hex_misses),
+                (unsigned) dispatch_stats.text_hits,
+                (unsigned) (dispatch_stats.text_hits + dispatch_stats.text_misses),
+                (unsigned) dispatch_stats.textframe_hits,
+                (unsigned) (dispatch_stats.textframe_hits + dispatch_stats.textframe_misses),
+                (unsigned) dispatch_stats.text_shape_hits,
+                (unsigned) (dispatch_stats.text_shape_hits + dispatch_stats.text_shape_misses));
+  ESP_LOGCONFIG(this->logtag_, "Stale timeout: %u ms", (unsigned) this->stale_timeout_);
+#if defined(VEDIRECT_USE_HEXFRAME)
+  auto &request_queues = this->request_queues_;
+  ESP_LOGCONFIG(this->logtag_,
+                "Requests: queue size=%u, scheduling=%s, dropped (interactive/automation/polling/keepalive)=%u/%u/%u/%u",
+                (unsigned) VEDIRECT_REQUEST_QUEUE_SIZE,
+                this->request_scheduling_ == RequestScheduling::Strict ? "strict" : "weighted",
+                (unsigned) request_queues[RequestClass::Interactive].dropped,
+                (unsigned) request_queues[RequestClass::Automation].dropped,
+                (unsigned) request_queues[RequestClass::Polling].dropped,
+                (unsigned) request_queues[RequestClass::Keepalive].dropped);
+  ESP_LOGCONFIG(this->logtag_, "Requests coalesced: %u/%u", (unsigned) this->requests_coalesced_,
+                (unsigned) this->requests_count_);
+#if defined(VEDIRECT_USE_TEXTFRAME)
+  ESP_LOGCONFIG(this->logtag_,
+                "Requests TEXT sync: %s, period=%u ms, duration=%u ms (%u samples), collisions avoided=%u, "
+                "late replies=%u",
+                YESNO(this->textframe_sync_), (unsigned) this->textframe_cadence_.period,
+                (unsigned) this->textframe_cadence_.duration, (unsigned) this->textframe_cadence_.samples,
+                (unsigned) this->requests_collisions_avoided_, (unsigned) this->requests_late_replies_);
+#endif
+  ESP_LOGCONFIG(this->logtag_, "Requests pipeline: window=%u (max=%u), last polling rate=%.1f registers/s",
+                (unsigned) this->pipeline_window_current_(), (unsigned) this->pipeline_window_, this->polling_rate_);
+  for (uint8_t rtt_class = 0; rtt_class < RttClass_COUNT; ++rtt_class) {
+    static const char *const RTT_CLASSES[RttClass_COUNT] = {"GET", "SET", "PING", "command"};
+    auto &rtt_estimator = this->rtt_estimators_[rtt_class];
+    ESP_LOGCONFIG(this->logtag_, "Requests %s: rtt=%u ms, rttvar=%u ms, timeout=%u ms (%u samples)",
+                  RTT_CLASSES[rtt_class], (unsigned) (rtt_estimator.srtt >> 3), (unsigned) (rtt_estimator.rttvar >> 2),
+                  (unsigned) this->get_request_timeout((RttClass) rtt_class), (unsigned) rtt_estimator.samples);
+    auto &retry_policy = this->retry_policies_[rtt_class];
+    if (retry_policy.max_attempts > 1)
+      ESP_LOGCONFIG(this->logtag_, "  retry policy: max attempts=%u, backoff=%u ms, priority=%s",
+                    retry_policy.max_attempts, retry_policy.backoff, YESNO(retry_policy.priority));
+    auto &request_stats = this->request_stats_[rtt_class];
+    if (!request_stats.latency.count && !request_stats.errors[Error::QUEUE_FULL - Error::TIMEOUT])
+      continue;
+    auto &queue_wait = request_stats.queue_wait;
+    auto &rtt = request_stats.rtt;
+    auto &latency = request_stats.latency;
+    ESP_LOGCONFIG(this->logtag_, "  p50/p95/max (ms): queue wait=%u/%u/%u, rtt=%u/%u/%u, latency=%u/%u/%u",
+                  (unsigned) queue_wait.percentile(50), (unsigned) queue_wait.percentile(95), (unsigned) queue_wait.max,
+                  (unsigned) rtt.percentile(50), (unsigned) rtt.percentile(95), (unsigned) rtt.max,
+                  (unsigned) latency.percentile(50), (unsigned) latency.percentile(95), (unsigned) latency.max);
+    auto errors = request_stats.errors;
+    ESP_LOGCONFIG(this->logtag_, "  samples=%u, timeout=%u, unexpected=%u, remote=%u, flags=%u, queue full=%u",
+                  (unsigned) latency.count, (unsigned) errors[Error::TIMEOUT - Error::TIMEOUT],
+                  (unsigned) errors[Error::UNEXPECTED - Error::TIMEOUT],
+                  (unsigned) errors[Error::REMOTE - Error::TIMEOUT], (unsigned) errors[Error::FLAGS - Error::TIMEOUT],
+                  (unsigned) errors[Error::QUEUE_FULL - Error::TIMEOUT]);
+    if (request_stats.retries)
+      ESP_LOGCONFIG(this->logtag_, "  retries=%u, successes after retry=%u", (unsigned) request_stats.retries,
+                    (unsigned) request_stats.retry_successes);
+  }
+  ESP_LOGCONFIG(this->logtag_, "Polling freshness: ttl=%u ms, skipped=%u", (unsigned) this->freshness_ttl_,
+                (unsigned) this->polling_skipped_);
+  if (this->poll_wheel_size_) {
+    ESP_LOGCONFIG(this->logtag_, "Periodic polling: registers=%u, load=%.2f requests/s, budget=%u requests/s",
+                  (unsigned) this->poll_wheel_size_, this->poll_load_ / 1000.f, (unsigned) this->poll_budget_);
+    for (auto it = this->hex_registers_.begin(); !it.is_end(); ++it) {
+      if (auto polling = it->polling_) {
+        ESP_LOGCONFIG(this->logtag_, "  0x%04X: interval=%u ms (%u..%u)", (unsigned) it->bucket_key(),
+                      (unsigned) polling->interval, (unsigned) polling->interval_min, (unsigned) polling->interval_max);
+      }
+    }
+  }
+#endif
 #if defined(VEDIRECT_USE_TEXTFRAME)
   HexRegistersMap::stats stats;
   TextRegistersMap::stats text_stats;
@@ -223,8 +540,15 @@ void Manager::init_entity(EntityBase *entity, const REG_DEF *reg_def, const char
 
 #if defined(VEDIRECT_USE_HEXFRAME)
 void Manager::send_hexframe(const HexFrame &hexframe) {
-  this->write_array((const uint8_t *) hexframe.encoded(), hexframe.encoded_size());
-  ESP_LOGD(this->logtag_, "HEX FRAME: sent %s", hexframe.encoded());
+  this->send_hexframe_encoded(hexframe.encoded(), hexframe.encoded_size());
+}
+
+void Manager::send_hexframe_encoded(const char *encoded, size_t encoded_size) {
+  if (this->tx_push_(encoded, encoded_size)) {
+    ESP_LOGD(this->logtag_, "HEX FRAME: queued %s", encoded);
+  } else {
+    ESP_LOGE(this->logtag_, "HEX FRAME: not queued (tx buffer full or malformed frame) %s", encoded);
+  }
 }
 
 void Manager::send_hexframe(const char *rawframe, bool addchecksum) {
@@ -236,36 +560,78 @@ void Manager::send_hexframe(const char *rawframe, bool addchecksum) {
   }
 }
 
-bool Manager::request(HEXFRAME::COMMAND command, register_id_t register_id, const void *data, size_t data_size,
-                      request_callback_t &&callback) {
-  if (this->is_request_queue_full()) {
-    ESP_LOGW(this->logtag_, "HEX FRAME: queue full, dropping request (cmd '%01X' - reg '0x%04X')", command,
-             register_id);
+bool Manager::request(RequestClass request_class, HEXFRAME::COMMAND command, register_id_t register_id,
+                      const void *data, size_t data_size, request_callback_t &&callback) {
+  ++this->requests_count_;
+  if (data_size > sizeof(Request::data)) {
+    ESP_LOGE(this->logtag_, "HEX FRAME: data size (%u) overflow on request (cmd '%01X' - reg '0x%04X')",
+             (unsigned) data_size, command, register_id);
+    if (callback) {
+      callback(nullptr, Error::OVERFLOW);
+    }
+    return false;
+  }
+  auto &queue = this->request_queues_[request_class];
+  auto request = this->requests_free_;
+  auto coalesced = this->request_coalesce_(request_class, command, register_id);
+  // a coalesced request only needs a slot to carry its callback
+  if (coalesced ? (callback && !request) : (!request || (queue.size >= queue.depth))) {
+    ++queue.dropped;
+    ++this->request_stats_[rtt_class_(command)].errors[Error::QUEUE_FULL - Error::TIMEOUT];
+    ESP_LOGW(this->logtag_, "HEX FRAME: queue full, dropping request (class %u - cmd '%01X' - reg '0x%04X')",
+             request_class, command, register_id);
     if (callback) {
       callback(nullptr, Error::QUEUE_FULL);
     }
     return false;
   }
-  ESP_LOGD(this->logtag_, "HEX FRAME: queuing request (cmd '%01X' - reg '0x%04X')", command, register_id);
-  switch (command) {
-    case HEXFRAME::COMMAND::Get:
-      this->requests_write_->command_get(register_id);
-      break;
-    case HEXFRAME::COMMAND::Set:
-      this->requests_write_->command_set(register_id, data, data_size);
-      break;
-    default:
-      this->requests_write_->command(command);
-      break;
+  if (command == HEXFRAME::COMMAND::Set) {
+    // the entity might have been optimistically updated (i.e. out of sync with the device):
+    // ensure the reply will be effectively parsed
+    this->invalidate_payload_cache_(register_id);
   }
-  this->requests_write_->callback = std::move(callback);
-  if (!this->is_request_pending()) {
-    this->request_trigger_(this->requests_write_);
+  if (coalesced) {
+    ++this->requests_coalesced_;
+    ESP_LOGD(this->logtag_, "HEX FRAME: coalescing request (class %u - cmd '%01X' - reg '0x%04X')", request_class,
+             command, register_id);
+    if (command == HEXFRAME::COMMAND::Set) {
+      // last value wins: the callbacks of the superseded SETs will get the outcome of this one
+      memcpy(coalesced->data, data, data_size);
+      coalesced->data_size = data_size;
+    }
+    if (callback) {
+      // appended so that the callbacks are invoked in the order the requests were issued
+      this->requests_free_ = request->next;
+      request->callback = callback;
+      request->joined = nullptr;
+      while (coalesced->joined)
+        coalesced = coalesced->joined;
+      coalesced->joined = request;
+    }
+    return true;
   }
-  if (this->requests_write_ == this->requests_last_)
-    this->requests_write_ = this->requests_;
+  ESP_LOGD(this->logtag_, "HEX FRAME: queuing request (class %u - cmd '%01X' - reg '0x%04X')", request_class, command,
+           register_id);
+  this->requests_free_ = request->next;
+  request->callback = callback;
+  request->next = nullptr;
+  request->joined = nullptr;
+  request->time = millis();
+  request->queue_wait = 0;
+  request->register_id = register_id;
+  request->command = command;
+  request->data_size = data_size;
+  if (data_size)
+    memcpy(request->data, data, data_size);
+  request->request_class = request_class;
+  request->attempt = 0;
+  if (queue.tail)
+    queue.tail->next = request;
   else
-    ++this->requests_write_;
+    queue.head = request;
+  queue.tail = request;
+  ++queue.size;
+  this->request_dispatch_();
   return true;
 }
 #endif  // defined(VEDIRECT_USE_HEXFRAME)
@@ -278,9 +644,11 @@ void Manager::on_connected_() {
   if (polling_size) {
     ESP_LOGD(this->logtag_, "Polling begin (%d registers)", polling_size);
     this->polling_registers_it_ = this->hex_registers_.begin();
-    if (!this->is_request_pending()) {
-      this->poll_next_register_();
-    }  // else let the transaction management advance the polling
+    this->polling_sweep_ = true;
+    this->polling_count_ = 0;
+    this->polling_sweep_skipped_ = this->polling_skipped_;
+    this->polling_start_ = millis();
+    this->poll_registers_();
   }
 #endif
 #ifdef USE_BINARY_SENSOR
@@ -300,19 +668,45 @@ void Manager::on_disconnected_() {
     ESP_LOGD(this->logtag_, "Polling cancelled");
     this->polling_registers_it_ = this->hex_registers_.end();
   }
-  if (auto request = this->requests_read_) {
+  // (requests could be queued with none in flight when held back by a TEXT frame - see text_collision_)
+  if (this->requests_read_ || this->request_select_())
     ESP_LOGD(this->logtag_, "Cancelling pending requests");
-    for (; request != this->requests_write_;) {
-      if (request->callback) {
-        request->callback(nullptr, Error::TIMEOUT);
-      }
-      if (request == this->requests_last_)
-        request = this->requests_;
-      else
-        ++request;
+  // detach the in-flight list first so that callbacks issuing new requests don't mess with it
+  auto inflight = this->requests_read_;
+  this->requests_read_ = this->requests_read_last_ = nullptr;
+  this->requests_inflight_ = 0;
+  this->requests_tx_held_ = false;
+  while (inflight) {
+    auto next = inflight->next;
+    this->request_complete_(inflight, nullptr, Error::TIMEOUT);
+    inflight = next;
+  }
+  while (auto request = this->request_pop_())
+    this->request_complete_(request, nullptr, Error::TIMEOUT);
+  while (auto request = this->requests_retry_) {
+    this->requests_retry_ = request->next;
+    this->request_complete_(request, nullptr, Error::TIMEOUT);
+  }
+  while (auto transaction = this->read_transactions_) {
+    this->read_transactions_ = transaction->next_;
+    for (; transaction->submitted_ < transaction->size; ++transaction->submitted_) {
+      transaction->errors[transaction->submitted_] = Error::TIMEOUT;
+      --transaction->pending_;
     }
-    this->requests_read_ = nullptr;
+    if (!transaction->pending_)
+      this->read_complete_(transaction);
   }
+#if defined(VEDIRECT_USE_TEXTFRAME)
+  this->requests_held_ = false;
+  this->textframe_receiving_ = false;
+  this->textframe_burst_start_ = 0;
+  this->textframe_cadence_.samples = 0;
+#endif
+#if VEDIRECT_PROCEDURE_POOL_SIZE
+  // every awaited request has completed (TIMEOUT) by now
+  Procedure::cancel_(this);
+#endif
+  this->polling_pending_ = 0;
 #endif
 
 #ifdef USE_BINARY_SENSOR
@@ -322,64 +716,678 @@ void Manager::on_disconnected_() {
 #endif
 
   for (auto it = this->hex_registers_.begin(); !it.is_end(); ++it) {
+    it->payload_hash_ = 0;
+    it->update_source_ = Register::NoUpdate;
     it->link_disconnected_();
   }
 #if defined(VEDIRECT_USE_TEXTFRAME)
   // This could be not necessary but some TEXT registers might not be mapped to HEX registers.
   // At any rate link_disconnected_() is smart enough to avoid redundant updates.
   for (auto it = this->text_registers_.begin(); !it.is_end(); ++it) {
+    it->bucket_value()->payload_hash_ = 0;
+    it->bucket_value()->update_source_ = Register::NoUpdate;
     it->bucket_value()->link_disconnected_();
   }
+  this->textframe_fingerprints_[0] = this->textframe_fingerprints_[1] = 0;
+#endif
+}
+
+void Manager::invalidate_payload_cache_(register_id_t register_id) {
+  for (auto reg = this->hex_registers_.find(register_id); reg && (reg->bucket_key() == register_id);
+       reg = reg->bucket_next()) {
+    reg->payload_hash_ = 0;
+  }
+#if defined(VEDIRECT_USE_TEXTFRAME)
+  this->textframe_fingerprints_[0] = this->textframe_fingerprints_[1] = 0;
 #endif
 }
 
+void Manager::check_stale_(uint32_t now) {
+  const uint32_t stale_timeout = this->stale_timeout_;
+  unsigned stale_count = 0;
+  auto check_register = [now, stale_timeout, &stale_count](Register *reg) {
+    if ((reg->update_source_ != Register::NoUpdate) && ((now - reg->last_update_) >= stale_timeout)) {
+      // the payload cache is invalidated so that the next update gets published even if unchanged
+      reg->update_source_ = Register::NoUpdate;
+      reg->payload_hash_ = 0;
+      reg->link_disconnected_();
+      ++stale_count;
+    }
+  };
+  for (auto it = this->hex_registers_.begin(); !it.is_end(); ++it) {
+    check_register(&*it);
+  }
+#if defined(VEDIRECT_USE_TEXTFRAME)
+  // registers mapped in both the maps are only reported once since update_source_ was reset
+  for (auto it = this->text_registers_.begin(); !it.is_end(); ++it) {
+    check_register(it->bucket_value());
+  }
+#endif
+  if (stale_count) {
+    ESP_LOGD(this->logtag_, "%u register(s) stale", stale_count);
+#if defined(VEDIRECT_USE_TEXTFRAME)
+    this->textframe_fingerprints_[0] = this->textframe_fingerprints_[1] = 0;
+#endif
+  }
+}
+
 #if defined(VEDIRECT_USE_HEXFRAME)
+void Manager::request_dispatch_() {
+  while (auto queue = this->request_select_()) {
+    if (auto request = this->requests_read_) {
+      // only GETs are pipelined: anything else is sent when the link is idle and holds it
+      // until replied so that the ordering of SETs/commands against GETs is preserved
+      if ((this->requests_inflight_ >= this->pipeline_window_current_()) ||
+          (request->command != HEXFRAME::COMMAND::Get) || (queue->head->command != HEXFRAME::COMMAND::Get))
+        break;
+    }
+#if defined(VEDIRECT_USE_TEXTFRAME)
+    if (this->textframe_sync_ && this->text_collision_(millis(), rtt_class_(queue->head->command))) {
+      // released from loop() at requests_hold_until_ (or re-evaluated at the end of every TEXT frame)
+      if (!this->requests_held_) {
+        this->requests_held_ = true;
+        ++this->requests_collisions_avoided_;
+      }
+      break;
+    }
+    this->requests_held_ = false;
+#endif
+    if (this->tx_room_() < queue->head->frame_size()) {
+      // tx ring backlog: the request stays queued until tx_flush_ makes room (see loop)
+      this->requests_tx_held_ = true;
+      break;
+    }
+    this->requests_tx_held_ = false;
+    this->request_trigger_(this->request_pop_(queue));
+  }
+}
+
 void Manager::request_trigger_(Request *request) {
-  this->requests_read_ = request;
-  request->timeout = millis() + VEDIRECT_COMMAND_TIMEOUT_MILLIS;
-  this->write_array((const uint8_t *) request->encoded(), request->encoded_size());
+  const uint32_t now = millis();
+  // (retries accumulate the time spent on the previous attempts)
+  request->queue_wait = std::min<uint32_t>(request->queue_wait + (now - request->time), UINT16_MAX);
+  request->time = now;
+  ++request->attempt;
+  request->timeout = std::min<uint32_t>(this->get_request_timeout(rtt_class_(request->command)), UINT16_MAX);
+  // room for the frame was checked in request_dispatch_
+  switch (request->command) {
+    case HEXFRAME::COMMAND::Get:
+    case HEXFRAME::COMMAND::Set:
+      this->tx_push_command_((HEXFRAME::COMMAND) request->command, request->register_id, request->data,
+                             request->data_size);
+      break;
+    case HEXFRAME::COMMAND::Ping:
+      // keepalive: sent every ping_timeout_ so it is worth a precompiled frame
+      this->tx_push_(PING_FRAME.encoded(), PING_FRAME.encoded_size());
+      break;
+    default: {
+      const HexFrameConstT<0> tx_frame((HEXFRAME::COMMAND) request->command);
+      this->tx_push_(tx_frame.encoded(), tx_frame.encoded_size());
+      break;
+    }
+  }
+  // the timeout starts (and 'time' is stamped again) when tx_flush_ actually writes the frame
+  request->tx_end = this->tx_head_;
+  request->sent = false;
+  request->next = nullptr;
+  if (auto last = this->requests_read_last_) {
+    last->next = request;
+  } else {
+    this->requests_read_ = request;
+  }
+  this->requests_read_last_ = request;
+  ++this->requests_inflight_;
 }
 
 void Manager::request_response_(Request *request, const HexFrame *response, Error error) {
-// request is already valued with this->requests_read_
 #if ESPHOME_LOG_LEVEL
   if (error) {
-    ESP_LOGE(this->logtag_, "HEX FRAME: error {%s} on reply '%s' for request '%s'", FRAME_ERRORS[error],
-             response ? response->encoded() : "", request->encoded());
+    ESP_LOGE(this->logtag_, "HEX FRAME: error {%s} on reply '%s' for request (cmd '%01X' - reg '0x%04X')",
+             FRAME_ERRORS[error], response ? response->encoded() : "", request->command, request->register_id);
   } else {
-    ESP_LOGV(this->logtag_, "HEX FRAME: reply '%s' for request '%s'", response->encoded(), request->encoded());
+    ESP_LOGV(this->logtag_, "HEX FRAME: reply '%s' for request (cmd '%01X' - reg '0x%04X')", response->encoded(),
+             request->command, request->register_id);
   }
 #endif
-  if (request->callback) {
-    request->callback(response, error);
+  // unlink from the in-flight list (request is very likely the oldest one)
+  if (request == this->requests_read_) {
+    if (!(this->requests_read_ = request->next))
+      this->requests_read_last_ = nullptr;
+  } else {
+    auto prev = this->requests_read_;
+    while (prev->next != request)
+      prev = prev->next;
+    if (!(prev->next = request->next))
+      this->requests_read_last_ = prev;
+  }
+  --this->requests_inflight_;
+
+  const uint32_t now = millis();
+  const auto rtt_class = rtt_class_(request->command);
+  auto &request_stats = this->request_stats_[rtt_class];
+  if (response && ((error == Error::NONE) || (error == Error::FLAGS) || (error == Error::REMOTE))) {
+    const uint32_t rtt = now - request->time;
+    request_stats.rtt.add(rtt);
+#ifdef USE_SENSOR
+    this->request_stats_period_[1].add(rtt);
+#endif
+#if defined(VEDIRECT_USE_TEXTFRAME)
+    // replies held back by a TEXT frame would inflate the estimate
+    if ((int32_t) (this->textframe_end_ - request->time) >= 0)
+      ++this->requests_late_replies_;
+    else
+#endif
+      this->rtt_sample_(rtt_class, rtt);
+  }
+
+  if ((this->pipeline_window_ > 1) && (request->command == HEXFRAME::COMMAND::Get)) {
+    if ((error == Error::TIMEOUT) || (error == Error::UNEXPECTED)) {
+      // the device is likely dropping frames (input buffer overflow): multiplicative decrease
+      auto window = this->pipeline_window_current_();
+      this->pipeline_cwnd_ = std::max<uint16_t>(256, this->pipeline_cwnd_ / 2);
+      if (window != this->pipeline_window_current_())
+        ESP_LOGD(this->logtag_, "HEX FRAME: pipeline window shrunk to %u", this->pipeline_window_current_());
+    } else if ((this->pipeline_cwnd_ >> 8) < this->pipeline_window_) {
+      // additive increase: +1 every 'window' replies
+      this->pipeline_cwnd_ += 65536 / this->pipeline_cwnd_;
+    }
   }
-  if (request == this->requests_last_) {
-    request = this->requests_;
+
+  auto &retry_policy = this->retry_policies_[rtt_class];
+  if (is_retryable_(error) && (request->attempt < retry_policy.max_attempts)) {
+    // the frame (or its reply) was likely lost/corrupted: try again transparently to the callback(s)
+    const uint32_t backoff = (uint32_t) retry_policy.backoff << (request->attempt - 1);
+    ++request_stats.retries;
+    ESP_LOGD(this->logtag_, "HEX FRAME: retrying request (cmd '%01X' - reg '0x%04X') in %u ms (attempt %u/%u)",
+             request->command, request->register_id, (unsigned) backoff, request->attempt + 1,
+             retry_policy.max_attempts);
+    request->queue_wait = std::min<uint32_t>(request->queue_wait + (now - request->time) + backoff, UINT16_MAX);
+    request->time = now + backoff;
+    auto retry = &this->requests_retry_;
+    while (*retry && ((int32_t) (request->time - (*retry)->time) >= 0))
+      retry = &(*retry)->next;
+    request->next = *retry;
+    *retry = request;
+    this->request_retry_(now);
+    this->request_dispatch_();
+    return;
+  }
+
+  const uint32_t queue_wait = request->queue_wait;
+  const uint32_t latency = queue_wait + (now - request->time);
+  request_stats.queue_wait.add(queue_wait);
+  request_stats.latency.add(latency);
+  if (error >= Error::TIMEOUT)
+    ++request_stats.errors[error - Error::TIMEOUT];
+  else if (request->attempt > 1)
+    ++request_stats.retry_successes;
+#ifdef USE_SENSOR
+  this->request_stats_period_[0].add(queue_wait);
+  this->request_stats_period_[2].add(latency);
+#endif
+
+  this->request_complete_(request, response, error);
+  if (this->read_transactions_)
+    this->read_submit_();
+  this->request_dispatch_();
+}
+
+void Manager::request_retry_(uint32_t now) {
+  for (Request *request; (request = this->requests_retry_) && ((int32_t) (now - request->time) >= 0);) {
+    auto &queue = this->request_queues_[request->request_class];
+    if (queue.size >= queue.depth)
+      break;  // kept (due) in the retry list until the class queue has room
+    this->requests_retry_ = request->next;
+    if (this->retry_policies_[rtt_class_(request->command)].priority) {
+      if (!(request->next = queue.head))
+        queue.tail = request;
+      queue.head = request;
+    } else {
+      request->next = nullptr;
+      if (queue.tail)
+        queue.tail->next = request;
+      else
+        queue.head = request;
+      queue.tail = request;
+    }
+    ++queue.size;
+  }
+}
+
+bool Manager::request_read(ReadTransaction *transaction) {
+  if (transaction->pending_)
+    return false;
+  ESP_LOGD(this->logtag_, "HEX FRAME: read transaction (%u registers)", transaction->size);
+  transaction->manager_ = this;
+  transaction->time = millis();
+  transaction->submitted_ = 0;
+  if (!(transaction->pending_ = transaction->size)) {
+    this->read_complete_(transaction);
+    return true;
+  }
+  // transactions are submitted in order (FIFO)
+  auto last = &this->read_transactions_;
+  while (*last)
+    last = &(*last)->next_;
+  transaction->next_ = nullptr;
+  *last = transaction;
+  this->read_submit_();
+  return true;
+}
+
+void Manager::read_submit_() {
+  auto &queue = this->request_queues_[RequestClass::Automation];
+  const uint8_t window = this->pipeline_window_current_();
+  while (auto transaction = this->read_transactions_) {
+    // keep just enough reads outstanding to fill the pipeline (and never more than the queue can take)
+    // so that the other requests still find their slots: the rest follow as the reads complete
+    while ((transaction->submitted_ < transaction->size) &&
+           ((transaction->submitted_ - (transaction->size - transaction->pending_)) < window) &&
+           this->requests_free_ && (queue.size < queue.depth)) {
+      uint8_t index = transaction->submitted_++;
+      this->request(RequestClass::Automation, HEXFRAME::COMMAND::Get, transaction->register_ids[index], nullptr, 0,
+                    [transaction, index](const HexFrame *response, uint8_t error) {
+                      transaction->errors[index] = error;
+                      if (!--transaction->pending_)
+                        transaction->manager_->read_complete_(transaction);
+                    });
+    }
+    if (transaction->submitted_ < transaction->size)
+      return;
+    this->read_transactions_ = transaction->next_;
+  }
+}
+
+void Manager::read_complete_(ReadTransaction *transaction) {
+  for (uint8_t i = 0; i < transaction->size; ++i) {
+    if (transaction->errors[i] != Error::NONE)
+      continue;
+    auto register_id = transaction->register_ids[i];
+    for (auto reg = this->hex_registers_.find(register_id); reg && (reg->bucket_key() == register_id);
+         reg = reg->bucket_next()) {
+      reg->set_updated_(transaction->time, Register::HexReply);
+    }
+  }
+  ESP_LOGD(this->logtag_, "HEX FRAME: read transaction completed (%u/%u registers in %u ms)",
+           transaction->size - transaction->get_failed(), transaction->size, (unsigned) (millis() - transaction->time));
+  if (transaction->callback)
+    transaction->callback(transaction);
+}
+
+void Manager::request_complete_(Request *request, const HexFrame *response, Error error) {
+  // every slot is released before invoking its callback so that this could issue new requests
+  do {
+    auto callback = request->callback;
+    auto joined = request->joined;
+    request->next = this->requests_free_;
+    this->requests_free_ = request;
+    if (callback)
+      callback(response, error);
+    request = joined;
+  } while (request);
+}
+
+uint32_t Manager::get_request_timeout(RttClass rtt_class) const {
+  auto &rtt_estimator = this->rtt_estimators_[rtt_class];
+  if (!rtt_estimator.samples)
+    return this->request_timeout_max_;
+  uint32_t timeout = (rtt_estimator.srtt >> 3) + rtt_estimator.rttvar;
+  // (lower bound wins when misconfigured)
+  return std::max(this->request_timeout_min_, std::min(this->request_timeout_max_, timeout));
+}
+
+void Manager::rtt_sample_(RttClass rtt_class, uint32_t rtt) {
+  auto &rtt_estimator = this->rtt_estimators_[rtt_class];
+  if (!rtt_estimator.samples++) {
+    rtt_estimator.srtt = rtt << 3;
+    rtt_estimator.rttvar = rtt << 1;  // RTTVAR = RTT / 2
   } else {
-    ++request;
+    // SRTT += (RTT - SRTT) / 8 and RTTVAR += (|RTT - SRTT| - RTTVAR) / 4 in their scaled units
+    int32_t delta = (int32_t) rtt - (int32_t) (rtt_estimator.srtt >> 3);
+    rtt_estimator.srtt += delta;
+    if (delta < 0)
+      delta = -delta;
+    rtt_estimator.rttvar += delta - (int32_t) (rtt_estimator.rttvar >> 2);
   }
-  if (request == this->requests_write_) {
-    // all requests processed
-    this->requests_read_ = nullptr;
+}
+
+void Manager::Histogram::add(uint32_t value) {
+  auto &bucket = this->buckets[bucket_index(value)];
+  if (bucket == UINT16_MAX) {
+    this->count = 0;
+    for (auto &b : this->buckets)
+      this->count += (b >>= 1);
+  }
+  ++bucket;
+  ++this->count;
+  if (value > this->max)
+    this->max = value;
+}
+
+uint32_t Manager::Histogram::percentile(uint8_t percent) const {
+  uint32_t rank = (this->count * percent + 99) / 100;
+  uint32_t cumulative = 0;
+  for (uint8_t index = 0; index < BUCKETS - 1; ++index) {
+    if ((cumulative += this->buckets[index]) >= rank)
+      return std::min(bucket_value(index + 1) - 1, this->max);
+  }
+  return this->max;
+}
+
+uint8_t Manager::Histogram::bucket_index(uint32_t value) {
+  if (value < 2)
+    return value;
+  // 2 buckets per power of 2: the msb position and the bit following it
+  uint8_t msb = 31 - __builtin_clz(value);
+  uint8_t index = 2 * msb + ((value >> (msb - 1)) & 1);
+  return std::min<uint8_t>(index, BUCKETS - 1);
+}
+
+uint32_t Manager::Histogram::bucket_value(uint8_t index) {
+  if (index < 2)
+    return index;
+  return (2 | (index & 1)) << ((index >> 1) - 1);
+}
+
+#ifdef USE_SENSOR
+void Manager::request_stats_publish_(uint32_t now) {
+  this->request_stats_publish_time_ = now + VEDIRECT_STATS_PUBLISH_MILLIS;
+  auto sensors = this->request_stats_sensors_;
+  for (uint8_t i = 0; i < 3; ++i) {
+    auto &histogram = this->request_stats_period_[i];
+    bool empty = !histogram.count;
+    if (auto sensor = sensors[QueueWaitP50 + 3 * i])
+      sensor->publish_state(empty ? NAN : histogram.percentile(50));
+    if (auto sensor = sensors[QueueWaitP95 + 3 * i])
+      sensor->publish_state(empty ? NAN : histogram.percentile(95));
+    if (auto sensor = sensors[QueueWaitMax + 3 * i])
+      sensor->publish_state(empty ? NAN : histogram.max);
+    histogram.clear();
+  }
+  for (uint8_t error = Error::TIMEOUT; error < Error::_COUNT; ++error) {
+    if (auto sensor = sensors[Timeouts + error - Error::TIMEOUT]) {
+      uint32_t count = 0;
+      for (auto &request_stats : this->request_stats_)
+        count += request_stats.errors[error - Error::TIMEOUT];
+      sensor->publish_state(count);
+    }
+  }
+  if (sensors[Retries] || sensors[RetrySuccesses]) {
+    uint32_t retries = 0, retry_successes = 0;
+    for (auto &request_stats : this->request_stats_) {
+      retries += request_stats.retries;
+      retry_successes += request_stats.retry_successes;
+    }
+    if (auto sensor = sensors[Retries])
+      sensor->publish_state(retries);
+    if (auto sensor = sensors[RetrySuccesses])
+      sensor->publish_state(retry_successes);
+  }
+  if (auto sensor = sensors[CollisionsAvoided])
+    sensor->publish_state(this->requests_collisions_avoided_);
+  if (auto sensor = sensors[LateReplies])
+    sensor->publish_state(this->requests_late_replies_);
+}
+#endif
+
+Manager::Request *Manager::request_coalesce_(RequestClass request_class, HEXFRAME::COMMAND command,
+                                             register_id_t register_id) {
+  if ((command != HEXFRAME::COMMAND::Get) && (command != HEXFRAME::COMMAND::Set))
+    return nullptr;
+  Request *match = nullptr;
+  // A GET could join an in-flight GET (the reply is yet to come) while in-flight SETs
+  // are already on the wire and can't be updated anymore.
+  for (auto request = this->requests_read_; request; request = request->next) {
+    auto pending_command = request->command;
+    if (((pending_command == HEXFRAME::COMMAND::Get) || (pending_command == HEXFRAME::COMMAND::Set)) &&
+        (request->register_id == register_id)) {
+      if (pending_command != command)
+        return nullptr;  // mixed GET/SET sequence for the same register: keep the ordering
+      if (command == HEXFRAME::COMMAND::Get)
+        match = request;
+    }
+  }
+  // Requests waiting for a retry are not on the wire (any class could join them)
+  for (auto request = this->requests_retry_; request; request = request->next) {
+    auto pending_command = request->command;
+    if (((pending_command == HEXFRAME::COMMAND::Get) || (pending_command == HEXFRAME::COMMAND::Set)) &&
+        (request->register_id == register_id)) {
+      if (pending_command != command)
+        return nullptr;
+      if (!match)
+        match = request;
+    }
+  }
+  // Queued requests are eligible only when in the same or an higher priority class (lower RequestClass)
+  // so that the new caller will not be delayed.
+  for (int i = 0; i < RequestClass_COUNT; ++i) {
+    for (auto request = this->request_queues_[i].head; request; request = request->next) {
+      auto pending_command = request->command;
+      if (((pending_command == HEXFRAME::COMMAND::Get) || (pending_command == HEXFRAME::COMMAND::Set)) &&
+          (request->register_id == register_id)) {
+        if (pending_command != command)
+          return nullptr;
+        if (!match && (i <= request_class))
+          match = request;
+      }
+    }
+  }
+  return match;
+}
+
+Manager::RequestQueue *Manager::request_select_() {
+  RequestQueue *queue = nullptr;
+  if (this->request_scheduling_ == RequestScheduling::Strict) {
+    for (auto &q : this->request_queues_) {
+      if (q.head)
+        return &q;
+    }
+  } else {
+    // smooth weighted round-robin (as in nginx upstreams): every backlogged class earns its weight,
+    // the richest is served and pays back the total so that classes interleave according to weights.
+    for (auto &q : this->request_queues_) {
+      if (q.head && (!queue || ((q.credit + q.weight) > (queue->credit + queue->weight))))
+        queue = &q;
+    }
+  }
+  return queue;
+}
+
+Manager::Request *Manager::request_pop_(RequestQueue *queue) {
+  if (!queue && !(queue = this->request_select_()))
+    return nullptr;
+  if (this->request_scheduling_ == RequestScheduling::Weighted) {
+    int total = 0;
+    for (auto &q : this->request_queues_) {
+      if (q.head) {
+        q.credit += q.weight;
+        total += q.weight;
+      }
+    }
+    queue->credit -= total;
+  }
+  auto request = queue->head;
+  if (!(queue->head = request->next)) {
+    queue->tail = nullptr;
+    queue->credit = 0;
+  }
+  --queue->size;
+  request->next = nullptr;
+  return request;
+}
+
+void Manager::poll_registers_() {
+  auto &queue = this->request_queues_[RequestClass::Polling];
+  while (this->connected_ && (this->polling_pending_ < this->pipeline_window_current_()) &&
+         (queue.size < queue.depth) && this->requests_free_) {
     if (this->is_polling()) {
       this->poll_next_register_();
+    } else if (auto reg = this->poll_due_head_) {
+      uint32_t now = millis();
+      auto polling = reg->polling_;
+      // half the period at most so that the reply to our own previous poll doesn't count
+      bool fresh = reg->is_fresh(now, std::min(this->freshness_ttl_, polling->interval / 2));
+      if (this->poll_budget_ && !fresh) {
+        // token bucket (milli-requests) refilled at poll_budget_ requests/s up to a 1 s burst
+        this->poll_tokens_ =
+            std::min(this->poll_budget_ * 1000,
+                     this->poll_tokens_ + std::min<uint32_t>(now - this->poll_tokens_time_, 1000) * this->poll_budget_);
+        this->poll_tokens_time_ = now;
+        if (this->poll_tokens_ < 1000)
+          break;  // retried on next wheel tick
+        this->poll_tokens_ -= 1000;
+      }
+      if (!(this->poll_due_head_ = polling->next))
+        this->poll_due_tail_ = nullptr;
+      // the next period starts from the former due time so that the register keeps its phase
+      // unless we're lagging behind by more than a period
+      uint32_t due = polling->due + polling->interval;
+      if ((int32_t) (due - now) < 0)
+        due = now + polling->interval;
+      this->poll_schedule_(reg, due);
+      if (fresh) {
+        ++this->polling_skipped_;
+        continue;
+      }
+      this->poll_register_(reg->bucket_key(), polling->interval_min < polling->interval_max ? reg : nullptr);
+    } else {
+      break;
     }
-  } else {
-    this->request_trigger_(request);
   }
 }
 
 void Manager::poll_next_register_() {
-  // TODO: skip already updated registers and/or TEXT registers
+  const uint32_t now = millis();
   register_id_t register_id = this->polling_registers_it_->bucket_key();
-  this->request_get(register_id, [this, register_id](const HexFrame *, uint8_t) {
-    while (register_id == this->polling_registers_it_->bucket_key()) {
-      if ((++this->polling_registers_it_).is_end()) {
-        ESP_LOGD(this->logtag_, "Polling end");
-        break;
+  // advance now (rather than on reply) so that more registers could be in flight:
+  // a single GET will update all of the registers sharing the same id so that
+  // it is skipped only if all of them were recently updated (i.e. by TEXT frames)
+  bool fresh = true;
+  do {
+    fresh = fresh && this->polling_registers_it_->is_fresh(now, this->freshness_ttl_);
+  } while (!(++this->polling_registers_it_).is_end() && (register_id == this->polling_registers_it_->bucket_key()));
+  if (fresh) {
+    ++this->polling_skipped_;
+    if (!this->is_polling() && !this->polling_pending_)
+      this->poll_sweep_end_();
+    return;
+  }
+  this->poll_register_(register_id, nullptr);
+}
+
+void Manager::poll_sweep_end_() {
+  this->polling_sweep_ = false;
+  uint32_t elapsed = millis() - this->polling_start_;
+  this->polling_rate_ = elapsed ? this->polling_count_ * 1000.f / elapsed : 0;
+  ESP_LOGD(this->logtag_, "Polling end (%u registers in %u ms: %.1f registers/s, %u fresh skipped)",
+           (unsigned) this->polling_count_, (unsigned) elapsed, this->polling_rate_,
+           (unsigned) (this->polling_skipped_ - this->polling_sweep_skipped_));
+}
+
+void Manager::poll_register_(register_id_t register_id, Register *adaptive_register) {
+  // accounting is done in the callback since the request could be coalesced with another one
+  auto callback = [this, adaptive_register](const HexFrame *response, uint8_t error) {
+    if (!this->connected_)
+      return;  // cancelled (on_disconnected_ resets the polling state)
+    --this->polling_pending_;
+    if (adaptive_register && !error)
+      this->poll_adapt_(adaptive_register, response);
+    if (this->polling_sweep_) {
+      if (!error)
+        ++this->polling_count_;
+      if (!this->is_polling() && !this->polling_pending_)
+        this->poll_sweep_end_();
+    }
+    this->poll_registers_();
+  };
+  ++this->polling_pending_;
+  if (!this->request(RequestClass::Polling, HEXFRAME::COMMAND::Get, register_id, nullptr, 0, std::move(callback)))
+    --this->polling_pending_;
+}
+
+void Manager::poll_adapt_(Register *reg, const HexFrame *response) {
+  auto polling = reg->polling_;
+  int32_t value;
+  switch (reg->reg_def_->data_type) {
+    case HEXFRAME::DATA_TYPE::SN8:
+      value = (int8_t) response->safe_data_u32();
+      break;
+    case HEXFRAME::DATA_TYPE::SN16:
+      value = (int16_t) response->safe_data_u32();
+      break;
+    case HEXFRAME::DATA_TYPE::VARIADIC:
+      // any change in (untyped) payloads is significant
+      value = payload_hash_(PAYLOAD_HASH_SEED_HEX, response->data_begin(), response->data_end());
+      break;
+    default:
+      value = response->safe_data_u32();
+      break;
+  }
+  uint32_t interval = polling->interval;
+  if (polling->value_ok && ((uint32_t) std::abs((int64_t) value - polling->value) > polling->threshold)) {
+    // changing: halve the period unless it would overflow the polling budget
+    interval = std::max(polling->interval_min, interval / 2);
+    if (this->poll_budget_ &&
+        ((this->poll_load_ - 1000000 / polling->interval + 1000000 / interval) > this->poll_budget_ * 1000))
+      interval = polling->interval;
+  } else {
+    // stable: grow back (+25%) toward the configured update_interval
+    interval = std::min(polling->interval_max, interval + interval / 4);
+  }
+  polling->value = value;
+  polling->value_ok = true;
+  if (interval != polling->interval) {
+    ESP_LOGV(this->logtag_, "Polling 0x%04X: interval %u -> %u ms", (unsigned) reg->bucket_key(),
+             (unsigned) polling->interval, (unsigned) interval);
+    this->poll_load_ += 1000000 / interval - 1000000 / polling->interval;
+    polling->interval = interval;
+  }
+}
+
+void Manager::poll_schedule_(Register *reg, uint32_t due) {
+  // never schedule into an already processed tick
+  if ((int32_t) (due - this->poll_wheel_time_) < 0)
+    due = this->poll_wheel_time_;
+  auto polling = reg->polling_;
+  polling->due = due;
+  auto &slot = this->poll_wheel_[(due / VEDIRECT_POLL_WHEEL_TICK_MILLIS) & (VEDIRECT_POLL_WHEEL_SIZE - 1)];
+  polling->next = slot;
+  slot = reg;
+}
+
+void Manager::poll_wheel_tick_(uint32_t millis_) {
+  static constexpr uint32_t WHEEL_PERIOD = VEDIRECT_POLL_WHEEL_SIZE * VEDIRECT_POLL_WHEEL_TICK_MILLIS;
+  if ((millis_ - this->poll_wheel_time_) >= WHEEL_PERIOD) {
+    // the loop stalled for more than a whole round: visiting every slot once is enough
+    this->poll_wheel_time_ = (millis_ & ~(VEDIRECT_POLL_WHEEL_TICK_MILLIS - 1)) - WHEEL_PERIOD +
+                             VEDIRECT_POLL_WHEEL_TICK_MILLIS;
+  }
+  do {
+    auto &slot = this->poll_wheel_[(this->poll_wheel_time_ / VEDIRECT_POLL_WHEEL_TICK_MILLIS) &
+                                   (VEDIRECT_POLL_WHEEL_SIZE - 1)];
+    Register *reg = slot;
+    slot = nullptr;
+    while (reg) {
+      auto polling = reg->polling_;
+      auto next = polling->next;
+      if ((int32_t) (polling->due - this->poll_wheel_time_) < (int32_t) VEDIRECT_POLL_WHEEL_TICK_MILLIS) {
+        polling->next = nullptr;
+        if (this->poll_due_tail_)
+          this->poll_due_tail_->polling_->next = reg;
+        else
+          this->poll_due_head_ = reg;
+        this->poll_due_tail_ = reg;
+      } else {
+        // due in a later round
+        polling->next = slot;
+        slot = reg;
       }
+      reg = next;
     }
-  });
+    this->poll_wheel_time_ += VEDIRECT_POLL_WHEEL_TICK_MILLIS;
+  } while ((int32_t) (millis_ - this->poll_wheel_time_) >= 0);
+  if (this->poll_due_head_)
+    this->poll_registers_();
 }
 
 void Manager::on_frame_hex_(const RxHexFrame &hexframe) {
@@ -407,14 +1415,22 @@ void Manager::on_frame_hex_(const RxHexFrame &hexframe) {
     switch (rx_command) {
       case HEXFRAME::COMMAND::Get:
       case HEXFRAME::COMMAND::Set:
-        this->request_response_(request, &hexframe,
-                                (request->command() != rx_command) || (request->register_id() != hexframe.register_id())
-                                    ? Error::UNEXPECTED
-                                    : (hexframe.flags() ? Error::FLAGS : Error::NONE));
+        // when pipelining, the reply could match any of the in-flight requests
+        for (auto match = request; match; match = match->next) {
+          if ((match->command == rx_command) && (match->register_id == hexframe.register_id())) {
+            // the device replies in order so that any request sent before the matching one is lost:
+            // fail them now rather than waiting for their timeout
+            while (this->requests_read_ != match)
+              this->request_response_(this->requests_read_, nullptr, Error::TIMEOUT);
+            this->request_response_(match, &hexframe, hexframe.flags() ? Error::FLAGS : Error::NONE);
+            goto _forward_to_register;
+          }
+        }
+        this->request_response_(request, &hexframe, Error::UNEXPECTED);
         goto _forward_to_register;
       case HEXFRAME::COMMAND::PingResp:
         this->request_response_(request, &hexframe,
-                                request->command() != HEXFRAME::COMMAND::Ping ? Error::UNEXPECTED : Error::NONE);
+                                request->command != HEXFRAME::COMMAND::Ping ? Error::UNEXPECTED : Error::NONE);
         return;
       case HEXFRAME::COMMAND::Done:
         this->request_response_(request, &hexframe, Error::NONE);
@@ -441,10 +1457,24 @@ _forward_to_register:
     ESP_LOGE(this->logtag_, "HEX FRAME: inconsistent size: %s", hexframe.encoded());
     return;
   }
+  // flags and data are enough to detect a change
+  uint32_t payload_hash = payload_hash_(PAYLOAD_HASH_SEED_HEX, hexframe.begin() + 3, hexframe.end());
+  const auto update_source = rx_command == HEXFRAME::COMMAND::Async ? Register::HexAsync : Register::HexReply;
   Register *reg = this->hex_registers_.find(hexframe.register_id());
   if (reg) {
   __forward_next_hex:
-    reg->parse_hex(&hexframe);
+    reg->set_updated_(this->last_rx_, update_source);
+    if (reg->payload_hash_ == payload_hash) {
+      ++this->dispatch_stats_.hex_hits;
+    } else {
+      ++this->dispatch_stats_.hex_misses;
+      reg->payload_hash_ = payload_hash;
+      reg->parse_hex(&hexframe);
+#if defined(VEDIRECT_USE_TEXTFRAME)
+      // the register could also be fed by TEXT frames which then must not be skipped
+      this->textframe_fingerprints_[0] = this->textframe_fingerprints_[1] = 0;
+#endif
+    }
     // check if frame needs cascading
     reg = reg->bucket_next();
     if (reg && (reg->bucket_key() == hexframe.register_id())) {
@@ -460,6 +1490,8 @@ _forward_to_register:
       reg_def = new REG_DEF(hexframe.register_id(), nullptr, REG_DEF::CLASS::VOID, REG_DEF::ACCESS::READ_ONLY);
     }
     reg = Register::auto_create(this, reg_def);
+    reg->payload_hash_ = payload_hash;
+    reg->set_updated_(this->last_rx_, update_source);
     reg->parse_hex(&hexframe);
   }
 }
@@ -474,23 +1506,91 @@ void Manager::on_frame_hex_error_(FrameHandler::Error error) {
 #endif  // #if defined(VEDIRECT_USE_HEXFRAME)
 
 #if defined(VEDIRECT_USE_TEXTFRAME)
-void Manager::on_frame_text_(TextRecord **text_records, uint8_t text_records_count) {
-  ESP_LOGV(this->logtag_, "TEXT FRAME: processing");
+bool Manager::on_frame_text_name_(TextRecord &text_record, const char *name, uint8_t hash) {
+  // lookup the register(s) once while the frame is being parsed: the record value
+  // is not even stored if nobody is interested in it.
+  TextRegistersMap::bucket_type *bucket;
+  auto index = this->text_record_index();
+  if (index < VEDIRECT_TEXT_SHAPE_SIZE) {
+    if (index == 0) {
+      // select the frame shape starting with this label or recycle the least recently used one
+      auto text_shapes = this->text_shapes_;
+      if (text_shape_match_(text_shapes[0][0], name)) {
+        this->text_shape_ = text_shapes[0];
+      } else if (text_shape_match_(text_shapes[1][0], name)) {
+        this->text_shape_ = text_shapes[1];
+      } else {
+        this->text_shape_ = this->text_shape_ == text_shapes[0] ? text_shapes[1] : text_shapes[0];
+      }
+    }
+    auto &slot = this->text_shape_[index];
+    if (text_shape_match_(slot, name)) {
+      ++this->dispatch_stats_.text_shape_hits;
+      bucket = slot.bucket;
+    } else {
+      ++this->dispatch_stats_.text_shape_misses;
+      bucket = slot.bucket = this->text_registers_.find(name, hash);
+      strncpy(slot.name, name, sizeof(slot.name));
+    }
+  } else {
+    bucket = this->text_registers_.find(name, hash);
+  }
+  text_record.binding = bucket;
+#ifdef USE_TEXT_SENSOR
+  if (this->rawtextframe_)
+    return true;
+#endif
+  return bucket || this->auto_create_text_entities_;
+}
 
-  if (!this->connected_)
-    this->on_connected_();
+void Manager::on_frame_text_(const TextFrame &textframe) {
+  ESP_LOGV(this->logtag_, "TEXT FRAME: processing");
 
   this->last_frame_rx_ = this->last_rx_;
+#if defined(VEDIRECT_USE_HEXFRAME)
+  if (!this->textframe_receiving_)
+    this->textframe_begin_(this->last_rx_);  // the whole frame was decoded in a single loop
+  this->textframe_receiving_ = false;
+  this->textframe_end_ = this->last_rx_;
+  if (this->requests_held_)
+    this->request_dispatch_();  // the burst could be over earlier than predicted
+#else
+  this->textframe_end_ = this->last_rx_;
+#endif
+  const uint8_t text_records_count = textframe.size();
+
+  auto payload = (const uint8_t *) textframe.payload();
+  uint32_t fingerprint = payload_hash_(PAYLOAD_HASH_SEED_TEXT, payload, payload + textframe.payload_size());
+  if ((fingerprint == this->textframe_fingerprints_[0]) || (fingerprint == this->textframe_fingerprints_[1])) {
+    ++this->dispatch_stats_.textframe_hits;
+    // nothing changed but the bound registers are still fresh
+    for (uint8_t i = 0; i < text_records_count; ++i) {
+      const TextRecord &text_record = textframe[i];
+      auto bucket = (TextRegistersMap::bucket_type *) text_record.binding;
+      if (!bucket)
+        continue;
+      const char *text_record_name = textframe.name(text_record);
+      do {
+        bucket->bucket_value()->set_updated_(this->last_rx_, Register::Text);
+      } while ((bucket = bucket->bucket_next()) && (strcmp(bucket->bucket_key(), text_record_name) == 0));
+    }
+    if (!this->connected_)
+      this->on_connected_();
+    return;
+  }
+  ++this->dispatch_stats_.textframe_misses;
+  this->textframe_fingerprints_[1] = this->textframe_fingerprints_[0];
+  this->textframe_fingerprints_[0] = fingerprint;
 
 #ifdef USE_TEXT_SENSOR
   if (auto rawtextframe = this->rawtextframe_) {
     std::string textframe_value;
-    textframe_value.reserve(text_records_count * sizeof(FrameHandler::TextRecord));
+    textframe_value.reserve(textframe.payload_size() + text_records_count);
     for (uint8_t i = 0; i < text_records_count; ++i) {
-      const TextRecord *text_record = text_records[i];
-      textframe_value.append(text_record->name);
+      const TextRecord &text_record = textframe[i];
+      textframe_value.append(textframe.name(text_record), text_record.name_len);
       textframe_value.append(":");
-      textframe_value.append(text_record->value);
+      textframe_value.append(textframe.value(text_record), text_record.value_len);
       textframe_value.append(",");
     }
     if (rawtextframe->raw_state != textframe_value) {
@@ -500,24 +1600,39 @@ void Manager::on_frame_text_(TextRecord **text_records, uint8_t text_records_cou
 #endif
 
   for (uint8_t i = 0; i < text_records_count; ++i) {
-    const TextRecord *text_record = text_records[i];
-    TextRegistersMap::bucket_type *bucket = this->text_registers_.find(text_record->name);
+    const TextRecord &text_record = textframe[i];
+    const char *text_record_name = textframe.name(text_record);
+    const char *text_record_value = textframe.value(text_record);
+    auto bucket = (TextRegistersMap::bucket_type *) text_record.binding;
+    uint32_t payload_hash = payload_hash_(PAYLOAD_HASH_SEED_TEXT, (const uint8_t *) text_record_value,
+                                          (const uint8_t *) text_record_value + text_record.value_len);
     if (bucket) {
     __forward_next_text:
-      bucket->bucket_value()->parse_text(text_record->value);
+      Register *reg = bucket->bucket_value();
+      reg->set_updated_(this->last_rx_, Register::Text);
+      if (reg->payload_hash_ == payload_hash) {
+        ++this->dispatch_stats_.text_hits;
+      } else {
+        ++this->dispatch_stats_.text_misses;
+        reg->payload_hash_ = payload_hash;
+        reg->parse_text(text_record, text_record_value);
+      }
       // check if record needs cascading
       bucket = bucket->bucket_next();
-      if (bucket && (strcmp(bucket->bucket_key(), text_record->name) == 0)) {
+      if (bucket && (strcmp(bucket->bucket_key(), text_record_name) == 0)) {
         goto __forward_next_text;
       }
       continue;
     }
 
     if (this->auto_create_text_entities_) {
-      ESP_LOGD(this->logtag_, "Auto-Creating TEXT register: %s", text_record->name);
+      // the same label could have been already auto-created earlier in this same frame
+      if ((bucket = this->text_registers_.find(text_record_name)))
+        goto __forward_next_text;
+      ESP_LOGD(this->logtag_, "Auto-Creating TEXT register: %s", text_record_name);
       Register *reg;
       const char *label;
-      auto text_def = TEXT_DEF::find_label(text_record->name);
+      auto text_def = TEXT_DEF::find_label(text_record_name);
       if (text_def) {
         label = text_def->label;
         // check if we have an already defined matching hex register
@@ -534,18 +1649,87 @@ void Manager::on_frame_text_(TextRecord **text_records, uint8_t text_records_cou
         // We lack the definition for this TEXT RECORD so
         // we return a plain TextSensor entity.
         // We allocate a copy since the label param is 'volatile'
-        label = strdup(text_record->name);
+        label = strdup(text_record_name);
         reg = Register::BUILD_ENTITY_FUNC[Register::TextSensor](this, nullptr, label);
       }
       this->text_registers_.insert(label, reg);
-      reg->parse_text(text_record->value);
+      // the new register could shadow a bucket already cached in the frame shapes
+      memset(this->text_shapes_, 0, sizeof(this->text_shapes_));
+      reg->payload_hash_ = payload_hash;
+      reg->set_updated_(this->last_rx_, Register::Text);
+      reg->parse_text(text_record, text_record_value);
     }
   }
+
+  // connecting only now so that the connection time polling could skip the registers just updated
+  if (!this->connected_)
+    this->on_connected_();
 }
 
 void Manager::on_frame_text_error_(FrameHandler::Error error) {
+#if defined(VEDIRECT_USE_HEXFRAME)
+  this->textframe_receiving_ = false;
+#endif
+  this->textframe_end_ = this->last_rx_;
   ESP_LOGE(this->logtag_, "TEXT FRAME: %s", FRAME_ERRORS[error]);
 }
+
+#if defined(VEDIRECT_USE_HEXFRAME)
+void Manager::textframe_begin_(uint32_t now) {
+  this->textframe_receiving_ = true;
+  if ((now - this->textframe_end_) < VEDIRECT_TEXT_BURST_GAP_MILLIS)
+    return;  // another block of the same burst
+  auto &cadence = this->textframe_cadence_;
+  const uint32_t burst_start = this->textframe_burst_start_;
+  const uint32_t period = now - burst_start;
+  const uint32_t duration = this->textframe_end_ - burst_start;
+  this->textframe_burst_start_ = now;
+  if (!burst_start || (period >= VEDIRECT_LINK_TIMEOUT_MILLIS) || (duration >= period)) {
+    cadence.samples = 0;  // first burst (or after a long silence)
+    return;
+  }
+  if (cadence.samples &&
+      ((period > cadence.period + cadence.period / 4) || (period < cadence.period - cadence.period / 4))) {
+    // a burst was missed (or garbled): relearn only if the cadence changed for good
+    if (++this->textframe_cadence_misses_ >= VEDIRECT_TEXT_CADENCE_SAMPLES) {
+      this->textframe_cadence_misses_ = 0;
+      cadence.samples = 0;
+    }
+    return;
+  }
+  this->textframe_cadence_misses_ = 0;
+  if (cadence.samples) {
+    cadence.period = (cadence.period * 7 + period) / 8;
+    cadence.duration = (cadence.duration * 7 + duration) / 8;
+  } else {
+    cadence.period = period;
+    cadence.duration = duration;
+  }
+  ++cadence.samples;
+}
+
+bool Manager::text_collision_(uint32_t now, RttClass rtt_class) {
+  auto &cadence = this->textframe_cadence_;
+  if (cadence.samples < VEDIRECT_TEXT_CADENCE_SAMPLES)
+    return false;
+  const uint32_t burst_end = cadence.duration + VEDIRECT_TEXT_GUARD_MILLIS;
+  const uint32_t phase = now - this->textframe_burst_start_;
+  if (this->textframe_receiving_ || (phase < burst_end)) {
+    // the current burst is (likely) still being sent
+    this->requests_hold_until_ =
+        phase < burst_end ? this->textframe_burst_start_ + burst_end : now + VEDIRECT_TEXT_GUARD_MILLIS;
+    return true;
+  }
+  // the reply is expected about a (smoothed) round trip time from now
+  const uint32_t reply_phase = phase + (this->rtt_estimators_[rtt_class].srtt >> 3) + VEDIRECT_TEXT_GUARD_MILLIS;
+  if ((reply_phase >= cadence.period) && (phase < cadence.period + burst_end)) {
+    this->requests_hold_until_ = this->textframe_burst_start_ + cadence.period + burst_end;
+    return true;
+  }
+  // past the predicted burst (it didn't come): don't hold anything until the next one resyncs us
+  return false;
+}
+#endif  // defined(VEDIRECT_USE_HEXFRAME)
 #endif  // #if defined(VEDIRECT_USE_TEXTFRAME)
 
 }  // namespace m3_vedirect
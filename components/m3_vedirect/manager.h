@@ -8,6 +8,9 @@
 #ifdef USE_BINARY_SENSOR
 #include "esphome/components/binary_sensor/binary_sensor.h"
 #endif
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
 #ifdef USE_TEXT_SENSOR
 #include "esphome/components/text_sensor/text_sensor.h"
 #endif
@@ -16,7 +19,9 @@
 #include "ve_reg_frame.h"
 #include "register.h"
 #include "containers.h"
+#include "procedure.h"
 
+#include <algorithm>
 #include <string_view>
 #include <string>
 #include <cstring>
@@ -29,7 +34,8 @@ namespace m3_vedirect {
 struct hash_textlabel {
   constexpr size_t operator()(const char *s) const {
     // validated on the actual set of VEDirect TEXT labels.
-    // this looks like a good trade-off between speed, size, and collisions
+    // this looks like a good trade-off between speed, size, and collisions.
+    // This must match FrameHandler::text_label_hash which computes the same while parsing the labels.
     unsigned char hash = *s;
     while (auto _s = *++s) {
       hash = (hash << 1) + _s;
@@ -73,6 +79,12 @@ class TextRegistersMap : public TinyMap<VEDIRECT_TEXTMAP_SIZE, const char *, Reg
     this->name##_ = name; \
   }
 
+// requests diagnostic sensors are stored in an array (see Manager::RequestStatsSensor)
+#define MANAGER_STATS_SENSOR_(name, index) \
+  void set_##name(sensor::Sensor *name) { /* NOLINT */ \
+    this->request_stats_sensors_[index] = name; \
+  }
+
 class Manager : public uart::UARTDevice, public Component, protected FrameHandler {
  public:
   enum Error : uint8_t {
@@ -118,7 +130,15 @@ class Manager : public uart::UARTDevice, public Component, protected FrameHandle
 #endif
 
  public:
-  Manager() : next_(Manager::list_) { Manager::list_ = this; }
+  Manager() : next_(Manager::list_) {
+    Manager::list_ = this;
+#if defined(VEDIRECT_USE_HEXFRAME)
+    for (auto &request : this->requests_) {
+      request.next = this->requests_free_;
+      this->requests_free_ = &request;
+    }
+#endif
+  }
 
   void setup() override;
   void loop() override;
@@ -129,6 +149,11 @@ class Manager : public uart::UARTDevice, public Component, protected FrameHandle
   void set_vedirect_id(const char *vedirect_id) { this->vedirect_id_ = vedirect_id; }
   const char *get_vedirect_name() { return this->vedirect_name_; }
   void set_vedirect_name(const char *vedirect_name) { this->vedirect_name_ = vedirect_name; }
+  /// @brief Maximum number of bytes decoded in a single loop iteration (0: decode everything available)
+  void set_rx_budget(uint32_t rx_budget) { this->rx_budget_ = rx_budget; }
+  /// @brief Registers not updated (by any frame) for longer than this (millis) are reported as unavailable
+  /// until the next update (0: disabled)
+  void set_stale_timeout(uint32_t stale_timeout) { this->stale_timeout_ = stale_timeout; }
   /// @brief Initialize and link the hex_register into the Manager dispatcher system
   /// @param hex_register : the register to be initialized/linked
   /// @param reg_def : the register descriptor definition
@@ -141,6 +166,8 @@ class Manager : public uart::UARTDevice, public Component, protected FrameHandle
 #if defined(VEDIRECT_USE_HEXFRAME)
   void set_auto_create_hex_entities(bool value) { this->auto_create_hex_entities_ = value; }
   void set_ping_timeout(uint32_t seconds) { this->ping_timeout_ = seconds * 1000; }
+  /// @brief Minimum time (millis) between the start of consecutive outgoing HEX frames (0: no pacing)
+  void set_tx_frame_gap(uint32_t tx_frame_gap) { this->tx_frame_gap_ = tx_frame_gap; }
 
   void add_on_frame_callback(std::function<void(const HexFrame &)> &&callback) {
     this->hexframe_callback_.add(std::move(callback));
@@ -160,6 +187,11 @@ class Manager : public uart::UARTDevice, public Component, protected FrameHandle
   template<typename... Ts> class Action_send_hexframe : public BaseAction<Ts...> {
    public:
     TEMPLATABLE_VALUE(std::string, data)
+    /// @brief Sets the frame encoded (and checksummed) by the codegen when 'data' is constant
+    void set_frame(const char *encoded, size_t encoded_size) {
+      this->frame_ = encoded;
+      this->frame_size_ = encoded_size;
+    }
 
 #if ESPHOME_VERSION_CODE >= VERSION_CODE(2025, 11, 0)
     // See https://github.com/esphome/esphome/pull/11704
@@ -168,9 +200,16 @@ class Manager : public uart::UARTDevice, public Component, protected FrameHandle
     void play(Ts... x) {
 #endif
         for (auto it = Manager::StaticIterator(this->vedirect_id_.value(x...)); it.has_next();) {
-          it.next()->send_hexframe(this->data_.value(x...));
+          if (this->frame_)
+            it.next()->send_hexframe_encoded(this->frame_, this->frame_size_);
+          else
+            it.next()->send_hexframe(this->data_.value(x...));
   }
 }
+
+protected:
+const char *frame_{nullptr};
+size_t frame_size_{0};
 };
 template<typename... Ts> class Action_send_command : public BaseAction<Ts...> {
  public:
@@ -228,6 +267,35 @@ void init_register(Register *reg, const char *label);
 const char *get_logtag() const { return this->logtag_; }
 bool is_connected() const { return this->connected_; }
 
+/// @brief Maximum number of bytes ever queued in the rx ring buffer
+uint32_t get_rx_high_water_mark() const { return this->rx_high_water_mark_; }
+/// @brief Number of times the rx ring buffer was full while the UART still had data pending
+uint32_t get_rx_overruns() const { return this->rx_overruns_; }
+#if defined(VEDIRECT_USE_HEXFRAME)
+/// @brief Bytes (HEX frames) ever queued in the tx ring buffer
+uint32_t get_tx_queued() const { return this->tx_head_; }
+/// @brief Bytes written to the UART from the tx ring buffer
+uint32_t get_tx_sent() const { return this->tx_tail_; }
+/// @brief Bytes (whole HEX frames) discarded since the tx ring buffer was full
+uint32_t get_tx_dropped() const { return this->tx_dropped_; }
+#endif
+
+/// @brief Counters for the raw payload change cache: 'hits' are dispatches skipped since
+/// the payload didn't change from the previous one (see Register::payload_hash_)
+struct DispatchStats {
+  uint32_t hex_hits;
+  uint32_t hex_misses;
+  uint32_t text_hits;
+  uint32_t text_misses;
+  /// @brief whole TEXT frames skipped since identical to one of the last two frames
+  uint32_t textframe_hits;
+  uint32_t textframe_misses;
+  /// @brief TEXT records resolved through the frame shape cache instead of the registers map
+  uint32_t text_shape_hits;
+  uint32_t text_shape_misses;
+};
+const DispatchStats &get_dispatch_stats() const { return this->dispatch_stats_; }
+
 /// @brief Initialize an entity (Register) with the correct naming/id scheme
 /// when dynamically created by the Manager.
 void init_entity(EntityBase *entity, const REG_DEF *reg_def, const char *name);
@@ -239,32 +307,203 @@ bool has_multi_manager() { return Manager::list_->next_ != nullptr; }
 // be lost if we send too many requests too quickly. To mitigate this, we'll
 // serialize the requests and wait for a response (or timeout) before sending
 // the next one.
-// This is a simple FIFO queue with a fixed maximum size.
+// Requests are queued in FIFOs (one for every RequestClass) sharing a fixed pool of
+// VEDIRECT_REQUEST_QUEUE_SIZE slots. Every class has its own depth limit so that
+// no class can exhaust the pool and the next request to send is picked by either strict
+// or weighted priority among the classes.
 //
 // In order to allow maximum flexibility, 2 api(s) are provided:
 // - 'send_xxx' api is provided in order to allow sending frames without
 // transaction control (this will disrupt any ongoing transactions though)
 // - 'request_xxx' api is provided in order to send a request and wait for a response
 // before sending the next request in the queue (VEDIRECT_REQUEST_QUEUE_SIZE define
-// can be used to set the queue depth - default is 5).
+// can be used to set the queue depth - default is 16).
 
 // send_xxx api: sends an HEX frame without transaction control (send and forget)
 // This is fragile since it 'collides' with transaction managed requests
 // so it should be used with care.
 void send_hexframe(const HexFrame &hexframe);
 void send_hexframe(const char *rawframe, bool addchecksum = true);
+/// @brief Sends an already encoded (and checksummed) frame i.e. a HexFrameConstT or
+/// the frames precompiled by the codegen for the send_hexframe action
+void send_hexframe_encoded(const char *encoded, size_t encoded_size);
 void send_hexframe(const std::string &rawframe, bool addchecksum = true) {
   this->send_hexframe(rawframe.c_str(), addchecksum);
 }
 
-typedef std::function<void(const HexFrame *, uint8_t)> request_callback_t;
+enum RequestClass : uint8_t {
+  Interactive,  // SET and commands (user actions should reach the device asap)
+  Automation,   // GET (automations/actions)
+  Polling,      // background registers polling
+  Keepalive,    // link keepalive (PING)
+  RequestClass_COUNT,
+};
+enum RequestScheduling : uint8_t {
+  Strict,    // always serve the highest priority (lowest RequestClass) queued request first
+  Weighted,  // smooth weighted round-robin among the classes with queued requests
+};
+void set_request_scheduling(RequestScheduling request_scheduling) { this->request_scheduling_ = request_scheduling; }
+/// @brief Maximum number of queued (not yet sent) requests for the class
+void set_request_class_depth(RequestClass request_class, uint8_t depth) {
+  this->request_queues_[request_class].depth = depth;
+}
+/// @brief Relative share of the link for the class when RequestScheduling::Weighted
+void set_request_class_weight(RequestClass request_class, uint8_t weight) {
+  this->request_queues_[request_class].weight = weight;
+}
+/// @brief Number of requests rejected (QUEUE_FULL) for the class
+uint32_t get_request_class_dropped(RequestClass request_class) const {
+  return this->request_queues_[request_class].dropped;
+}
+/// @brief Maximum number of GETs kept in flight (1 disables pipelining). The effective window
+/// adapts (AIMD) between 1 and this value depending on the device keeping up with the requests.
+void set_pipeline_window(uint8_t pipeline_window) {
+  this->pipeline_window_ = std::max<uint8_t>(1, std::min<uint8_t>(pipeline_window, VEDIRECT_REQUEST_QUEUE_SIZE / 2));
+}
+/// @brief Number of requests (GET/SET) merged into an already queued or in-flight one
+uint32_t get_requests_coalesced() const { return this->requests_coalesced_; }
+/// @brief Total number of requests issued (coalesced included)
+uint32_t get_requests_count() const { return this->requests_count_; }
+/// @brief Caps the periodic polling (and the adaptive polling periods) to this many requests per second
+void set_polling_budget(uint32_t polling_budget) { this->poll_budget_ = polling_budget; }
+/// @brief Registers/s achieved by the last completed polling cycle
+float get_polling_rate() const { return this->polling_rate_; }
+/// @brief Registers updated (TEXT records, HEX async frames or replies) less than this (millis) ago
+/// are not polled (0: always poll)
+void set_freshness_ttl(uint32_t freshness_ttl) { this->freshness_ttl_ = freshness_ttl; }
+/// @brief Number of polls (connection time or periodic) skipped since the register was fresh
+uint32_t get_polling_skipped() const { return this->polling_skipped_; }
+/// @brief Bounds (millis) of the request timeouts which are otherwise estimated from the measured round trip times.
+/// The upper bound is also used until the first reply for the class of commands is measured.
+/// Both are clamped to 65535 ms (Request::timeout is 16 bits).
+void set_request_timeout_min(uint32_t timeout_min) { this->request_timeout_min_ = timeout_min; }
+void set_request_timeout_max(uint32_t timeout_max) { this->request_timeout_max_ = timeout_max; }
+#if defined(VEDIRECT_USE_TEXTFRAME)
+/// @brief When enabled (default) the requests are sent only in the quiet window between the (predicted)
+/// TEXT frames bursts so that their replies are not delayed (or lost) by the device TEXT transmission
+void set_textframe_sync(bool textframe_sync) { this->textframe_sync_ = textframe_sync; }
+/// @brief Learned TEXT frames cadence: period (millis - burst start to burst start) and duration
+/// (millis - of a whole burst) are smoothed over the samples (bursts with a consistent period)
+struct TextCadence {
+  uint32_t period;
+  uint32_t duration;
+  uint32_t samples;
+};
+const TextCadence &get_textframe_cadence() const { return this->textframe_cadence_; }
+#endif
+/// @brief Number of times the requests were held back since their reply would have collided with a TEXT frame
+uint32_t get_requests_collisions_avoided() const { return this->requests_collisions_avoided_; }
+/// @brief Number of replies delayed by a TEXT frame (they're not sampled for the round trip time)
+uint32_t get_requests_late_replies() const { return this->requests_late_replies_; }
+/// @brief Round trip time estimation (TCP style - RFC 6298) for a class of commands (see rtt_index_)
+struct RttEstimator {
+  uint32_t srtt;    // smoothed round trip time (millis << 3)
+  uint32_t rttvar;  // round trip time mean deviation (millis << 2)
+  uint32_t samples;
+};
+enum RttClass : uint8_t {
+  RttGet,
+  RttSet,
+  RttPing,
+  RttCommand,  // any other command
+  RttClass_COUNT,
+};
+const RttEstimator &get_rtt_estimator(RttClass rtt_class) const { return this->rtt_estimators_[rtt_class]; }
+/// @brief The current timeout (millis) for the class of commands
+uint32_t get_request_timeout(RttClass rtt_class) const;
+/// @brief Requests of the class of commands failing with a line error (see is_retryable_) are resent (up to
+/// max_attempts in total) after 'backoff' millis (doubled at every retry) either at the head (priority) or at
+/// the tail of their queue. The callback (and the statistics) only see the outcome of the final attempt.
+void set_retry_policy(RttClass rtt_class, uint8_t max_attempts, uint16_t backoff, bool priority) {
+  this->retry_policies_[rtt_class] = {std::min<uint8_t>(max_attempts, 15), priority, backoff};
+}
+
+/// @brief Log-scale histogram of durations (millis) with 2 buckets per power of 2 so that percentiles
+/// are estimated within 50%. Counts are halved when a bucket saturates so that the shape is preserved.
+struct Histogram {
+  static constexpr uint8_t BUCKETS = 24;  // the last bucket collects everything from 3072 ms
+  uint16_t buckets[BUCKETS];
+  uint32_t count;
+  uint32_t max;
+  void add(uint32_t value);
+  /// @brief Estimated value (the upper bound of its bucket) not exceeded by 'percent' of the samples
+  uint32_t percentile(uint8_t percent) const;
+  void clear() { *this = {}; }
+  static uint8_t bucket_index(uint32_t value);
+  /// @brief The lowest value falling into the bucket
+  static uint32_t bucket_value(uint8_t index);
+};
+/// @brief Diagnostics for a class of commands (see RttClass)
+struct RequestStats {
+  Histogram queue_wait;  // queued -> sent
+  Histogram rtt;         // sent -> reply (only requests being replied)
+  Histogram latency;     // queued -> completion (any outcome)
+  // outcomes other than success: TIMEOUT, UNEXPECTED, REMOTE, FLAGS, QUEUE_FULL
+  uint32_t errors[Error::_COUNT - Error::TIMEOUT];
+  uint32_t retries;          // attempts resent (see set_retry_policy)
+  uint32_t retry_successes;  // requests succeeding after at least a retry
+};
+const RequestStats &get_request_stats(RttClass rtt_class) const { return this->request_stats_[rtt_class]; }
+#ifdef USE_SENSOR
+enum RequestStatsSensor : uint8_t {
+  QueueWaitP50,
+  QueueWaitP95,
+  QueueWaitMax,
+  RttP50,
+  RttP95,
+  RttMax,
+  LatencyP50,
+  LatencyP95,
+  LatencyMax,
+  Timeouts,
+  Unexpected,
+  RemoteErrors,
+  FlagsErrors,
+  QueueFull,
+  Retries,
+  RetrySuccesses,
+  CollisionsAvoided,
+  LateReplies,
+  RequestStatsSensor_COUNT,
+};
+MANAGER_STATS_SENSOR_(request_queue_wait_p50, QueueWaitP50)
+MANAGER_STATS_SENSOR_(request_queue_wait_p95, QueueWaitP95)
+MANAGER_STATS_SENSOR_(request_queue_wait_max, QueueWaitMax)
+MANAGER_STATS_SENSOR_(request_rtt_p50, RttP50)
+MANAGER_STATS_SENSOR_(request_rtt_p95, RttP95)
+MANAGER_STATS_SENSOR_(request_rtt_max, RttMax)
+MANAGER_STATS_SENSOR_(request_latency_p50, LatencyP50)
+MANAGER_STATS_SENSOR_(request_latency_p95, LatencyP95)
+MANAGER_STATS_SENSOR_(request_latency_max, LatencyMax)
+MANAGER_STATS_SENSOR_(request_timeouts, Timeouts)
+MANAGER_STATS_SENSOR_(request_unexpected, Unexpected)
+MANAGER_STATS_SENSOR_(request_remote_errors, RemoteErrors)
+MANAGER_STATS_SENSOR_(request_flags_errors, FlagsErrors)
+MANAGER_STATS_SENSOR_(request_queue_full, QueueFull)
+MANAGER_STATS_SENSOR_(request_retries, Retries)
+MANAGER_STATS_SENSOR_(request_retry_successes, RetrySuccesses)
+MANAGER_STATS_SENSOR_(request_collisions_avoided, CollisionsAvoided)
+MANAGER_STATS_SENSOR_(request_late_replies, LateReplies)
+#endif
+
+/// @brief Completion callback (inline storage: capture at most 2 pointers, nothing owning)
+typedef Delegate<void(const HexFrame *, uint8_t)> request_callback_t;
 /// @brief Send an HEX command/request with transaction management
+/// @param request_class the scheduling class of the request
 /// @param command the HEX command to send
 /// @param register_id the register id to use (ignored if command is not GET/SET)
 /// @param data the data to use (ignored if command is not SET)
 /// @param data_type the data type to use (ignored if command is not SET)
+bool request(RequestClass request_class, HEXFRAME::COMMAND command, register_id_t register_id,
+             const void *data, size_t data_size, request_callback_t &&callback);
+/// @brief Same as above with the request class inferred from the command
 bool request(HEXFRAME::COMMAND command, register_id_t register_id = REG_DEF::REGISTER_UNDEFINED,
-             const void *data = nullptr, size_t data_size = 0, request_callback_t &&callback = nullptr);
+             const void *data = nullptr, size_t data_size = 0, request_callback_t &&callback = nullptr) {
+  return this->request(command == HEXFRAME::COMMAND::Get    ? RequestClass::Automation
+                       : command == HEXFRAME::COMMAND::Ping ? RequestClass::Keepalive
+                                                            : RequestClass::Interactive,
+                       command, register_id, data, data_size, std::move(callback));
+}
 bool request_command(HEXFRAME::COMMAND command, request_callback_t &&callback = nullptr) {
   return this->request(command, REG_DEF::REGISTER_UNDEFINED, nullptr, 0, std::move(callback));
 }
@@ -279,8 +518,99 @@ bool request_set(register_id_t register_id, const void *data, size_t data_size,
   return this->request(HEXFRAME::COMMAND::Set, register_id, data, data_size, std::move(callback));
 }
 
+/// @brief A batch of GETs completing as a whole: the registers are read with the Automation class
+/// (pipelined and coalesced with any pending read) and submitted progressively as request slots
+/// become available so that the batch never fails with QUEUE_FULL. Every register successfully read
+/// is stamped with the same transaction time (see Register::get_last_update).
+struct ReadTransaction {
+  typedef Delegate<void(ReadTransaction *)> callback_t;
+  /// @brief The registers to read (storage owned by the caller)
+  const register_id_t *register_ids;
+  /// @brief The outcome (Error) for every register (storage owned by the caller - same size as register_ids)
+  uint8_t *errors;
+  uint8_t size;
+  /// @brief Invoked once when every read has completed
+  callback_t callback;
+  /// @brief millis() when the transaction was submitted
+  uint32_t time;
+  bool is_pending() const { return this->pending_; }
+  /// @brief Number of registers not successfully read
+  uint8_t get_failed() const {
+    uint8_t failed = 0;
+    for (uint8_t i = 0; i < this->size; ++i)
+      failed += this->errors[i] != Error::NONE;
+    return failed;
+  }
+
+ protected:
+  friend class Manager;
+  Manager *manager_;
+  ReadTransaction *next_;
+  uint8_t submitted_;
+  uint8_t pending_;
+};
+/// @brief Submits the transaction (which must stay alive until completion): returns false when already pending
+bool request_read(ReadTransaction *transaction);
+
+class ReadTransactionTrigger : public Trigger<uint8_t, const ReadTransaction &> {};
+
+template<typename... Ts> class Action_read_registers : public BaseAction<Ts...> {
+ public:
+  void set_register_ids(const std::vector<register_id_t> &register_ids) {
+    this->register_ids_ = register_ids;
+    this->errors_.resize(register_ids.size());
+  }
+  void set_on_complete(ReadTransactionTrigger *on_complete) { this->on_complete_ = on_complete; }
+
+#if ESPHOME_VERSION_CODE >= VERSION_CODE(2025, 11, 0)
+  void play(const Ts &...x) override {
+#else
+  void play(Ts... x) {
+#endif
+    auto it = Manager::StaticIterator(this->vedirect_id_.value(x...));
+    if (!it.has_next())
+      return;
+    auto manager = it.next();
+    auto &transaction = this->transaction_;
+    if (transaction.is_pending()) {
+      ESP_LOGW(manager->get_logtag(), "HEX FRAME: read transaction still pending");
+      return;
+    }
+    transaction.register_ids = this->register_ids_.data();
+    transaction.errors = this->errors_.data();
+    transaction.size = this->register_ids_.size();
+    transaction.callback = [this](ReadTransaction *transaction) {
+      if (this->on_complete_)
+        this->on_complete_->trigger(transaction->get_failed(), *transaction);
+    };
+    manager->request_read(&transaction);
+  }
+
+ protected:
+  std::vector<register_id_t> register_ids_;
+  std::vector<uint8_t> errors_;
+  ReadTransactionTrigger *on_complete_{nullptr};
+  ReadTransaction transaction_{};
+};
+
+#if VEDIRECT_PROCEDURE_POOL_SIZE
+// Awaitable api for Procedure coroutines (see procedure.h)
+Procedure::RequestAwaiter co_get(register_id_t register_id) {
+  return {this, nullptr, register_id, HEXFRAME::COMMAND::Get, 0, 0, {}};
+}
+template<typename T> Procedure::RequestAwaiter co_set(register_id_t register_id, T data) {
+  static_assert(sizeof(T) <= sizeof(uint32_t), "co_set: data type too large");
+  return {this, nullptr, register_id, HEXFRAME::COMMAND::Set, sizeof(T), (uint32_t) data, {}};
+}
+Procedure::RequestAwaiter co_command(HEXFRAME::COMMAND command) {
+  return {this, nullptr, REG_DEF::REGISTER_UNDEFINED, command, 0, 0, {}};
+}
+/// @brief Suspends the procedure for 'duration' millis (without blocking the loop)
+Procedure::SleepAwaiter co_sleep(uint32_t duration) { return {this, duration}; }
+#endif
+
 bool is_request_pending() const { return this->requests_read_; }
-bool is_request_queue_full() const { return this->requests_read_ == this->requests_write_; }
+bool is_request_queue_full() const { return !this->requests_free_; }
 
 bool is_polling() const { return !this->polling_registers_it_.is_end(); }
 #endif  //  defined(VEDIRECT_USE_HEXFRAME)
@@ -296,6 +626,62 @@ const char *vedirect_name_{nullptr};
 
 HexRegistersMap hex_registers_;
 
+// UART ingestion: data is drained from the UART into a persistent ring buffer and then decoded
+// in contiguous spans (up to rx_budget_ bytes per loop). rx_head_/rx_tail_ are free running
+// counters (masked on access) so that (rx_head_ - rx_tail_) is always the amount of queued data.
+static_assert((VEDIRECT_RX_BUFFER_SIZE & (VEDIRECT_RX_BUFFER_SIZE - 1)) == 0,
+              "VEDIRECT_RX_BUFFER_SIZE must be a power of 2");
+uint32_t rx_budget_{0};
+uint32_t rx_head_{0};
+uint32_t rx_tail_{0};
+uint32_t rx_high_water_mark_{0};
+uint32_t rx_overruns_{0};
+uint8_t rx_buffer_[VEDIRECT_RX_BUFFER_SIZE];
+inline bool rx_ingest_();
+inline void rx_decode_();
+
+#if defined(VEDIRECT_USE_HEXFRAME)
+// UART transmission: outgoing HEX frames are queued (whole frames or nothing) in a ring buffer
+// and written to the UART from loop() so that frame dispatching (i.e. reply callbacks issuing new
+// requests) never waits on the UART. A frame is written only when tx_frame_gap_ millis have elapsed
+// since the previous one. As for the rx ring, tx_head_/tx_tail_ are free running counters.
+static_assert((VEDIRECT_TX_BUFFER_SIZE & (VEDIRECT_TX_BUFFER_SIZE - 1)) == 0,
+              "VEDIRECT_TX_BUFFER_SIZE must be a power of 2");
+// any request frame (up to 19 bytes) must fit an empty ring and Request::tx_end is 16 bits
+static_assert((VEDIRECT_TX_BUFFER_SIZE >= 32) && (VEDIRECT_TX_BUFFER_SIZE <= 32768),
+              "VEDIRECT_TX_BUFFER_SIZE must be in the 32..32768 range");
+uint32_t tx_frame_gap_{0};
+uint32_t tx_last_{0};
+uint32_t tx_head_{0};
+uint32_t tx_tail_{0};
+uint32_t tx_dropped_{0};
+char tx_buffer_[VEDIRECT_TX_BUFFER_SIZE];
+/// @brief Queues an encoded frame (false and dropped if malformed or if it doesn't fit)
+bool tx_push_(const char *encoded, size_t encoded_size);
+/// @brief Encodes a GET/SET register frame straight into the ring (false and dropped if it doesn't fit)
+bool tx_push_command_(HEXFRAME::COMMAND command, register_id_t register_id, const uint8_t *data, size_t data_size);
+/// @brief Writes the queued frames to the UART according to tx_frame_gap_ and starts the
+/// timeout of the in-flight requests whose frame was written
+inline void tx_flush_(uint32_t now);
+uint32_t tx_room_() const { return VEDIRECT_TX_BUFFER_SIZE - (this->tx_head_ - this->tx_tail_); }
+#endif
+
+// raw payload change cache
+DispatchStats dispatch_stats_{};
+static constexpr uint32_t PAYLOAD_HASH_SEED_HEX = 0x811C9DC5;  // FNV-1a offset basis
+static constexpr uint32_t PAYLOAD_HASH_SEED_TEXT = 0x050C5D1F;
+/// @brief FNV-1a hash of a payload (never 0 since it is reserved for 'no payload').
+/// HEX and TEXT payloads use different seeds so that a register fed by both is
+/// always dispatched when the source changes (the encodings are different).
+static inline uint32_t payload_hash_(uint32_t hash, const uint8_t *data, const uint8_t *data_end) {
+  for (; data < data_end; ++data)
+    hash = (hash ^ *data) * 16777619;
+  return hash | 1;
+}
+/// @brief Invalidates the payload cache of all the registers with the given id (HEX)
+/// and the TEXT frame fingerprints so that the next dispatch is not skipped
+void invalidate_payload_cache_(register_id_t register_id);
+
 // component state
 bool connected_{false};
 int last_rx_{0};
@@ -304,6 +690,11 @@ int last_frame_rx_{0};
 inline void on_connected_();
 inline void on_disconnected_();
 
+uint32_t stale_timeout_{0};
+uint32_t stale_check_time_{0};
+/// @brief Reports as unavailable (link_disconnected_) the registers not updated since stale_timeout_
+void check_stale_(uint32_t now);
+
 #if defined(VEDIRECT_USE_HEXFRAME)
 bool auto_create_hex_entities_{false};
 int ping_timeout_{VEDIRECT_PING_TIMEOUT_MILLIS};
@@ -316,19 +707,189 @@ CallbackManager<void(const HexFrame &)> hexframe_callback_;
 
 /// @brief Context class for a request for an HEX command/request with transaction management
 /// so that the response (either succesfull or not) could be tracked and processed accordingly.
-struct Request : public HexFrameT<7> {
+/// Only the request parameters are stored: the frame is encoded (HexFrameConstT) when sent.
+struct Request {
   request_callback_t callback;
-  int timeout;
+  Request *next;
+  /// @brief Requests coalesced into this one (only carrying their callback)
+  Request *joined;
+  /// @brief millis() when queued, when its frame was queued in the tx ring and, once written, when sent
+  uint32_t time;
+  /// @brief (millis) timeout relative to 'time' once sent
+  uint16_t timeout;
+  /// @brief (millis - saturated) time spent in the queue (and in the tx ring) before being sent
+  uint16_t queue_wait;
+  register_id_t register_id;
+  /// @brief (16 bits) tx ring position past the request frame: sent once tx_tail_ gets there
+  uint16_t tx_end;
+  uint8_t command : 4;
+  uint8_t data_size : 4;
+  uint8_t request_class : 4;  // RequestClass
+  uint8_t attempt : 4;        // number of times sent
+  uint8_t sent : 1;           // frame written to the UART (the timeout is running)
+  uint8_t data[4];
+  uint32_t deadline() const { return this->time + this->timeout; }
+  /// @brief Size of the encoded frame (see request_trigger_)
+  size_t frame_size() const {
+    return ((this->command == HEXFRAME::COMMAND::Get) || (this->command == HEXFRAME::COMMAND::Set))
+               ? 1 + 1 + (2 + 1 + this->data_size) * 2 + 2 + 1
+               : 1 + 1 + 2 + 1;  // plain command
+  }
 } requests_[VEDIRECT_REQUEST_QUEUE_SIZE];
+/// @brief The failed requests waiting for their backoff to expire (ordered by Request::time i.e. their due time)
+Request *requests_retry_{nullptr};
+/// @brief The requests sent and waiting for the reply (oldest first, linked through Request::next)
 Request *requests_read_{nullptr};
-Request *requests_write_{requests_};
-Request *const requests_last_{&requests_[VEDIRECT_REQUEST_QUEUE_SIZE - 1]};
+Request *requests_read_last_{nullptr};
+uint8_t requests_inflight_{0};
+/// @brief Dispatching stopped since the next request frame doesn't fit the tx ring (resumed after tx_flush_)
+bool requests_tx_held_{false};
+Request *requests_free_{nullptr};
+struct RequestQueue {
+  Request *head;
+  Request *tail;
+  uint8_t size;
+  uint8_t depth;
+  uint8_t weight;
+  int16_t credit;  // RequestScheduling::Weighted state
+  uint32_t dropped;
+} request_queues_[RequestClass_COUNT]{
+    {nullptr, nullptr, 0, VEDIRECT_REQUEST_QUEUE_SIZE, 8, 0, 0},
+    {nullptr, nullptr, 0, VEDIRECT_REQUEST_QUEUE_SIZE - 2, 4, 0, 0},
+    {nullptr, nullptr, 0, 2, 2, 0, 0},
+    {nullptr, nullptr, 0, 1, 1, 0, 0},
+};
+RequestScheduling request_scheduling_{RequestScheduling::Strict};
+uint32_t requests_count_{0};
+uint32_t requests_coalesced_{0};
+uint32_t requests_collisions_avoided_{0};
+uint32_t requests_late_replies_{0};
+#if defined(VEDIRECT_USE_TEXTFRAME)
+/// @brief Requests are queued while waiting for the end of a (predicted) TEXT frames burst (see text_collision_)
+bool requests_held_{false};
+uint32_t requests_hold_until_{0};
+/// @brief Checks if the reply to a request of 'rtt_class' sent now would collide with a TEXT frames burst
+/// (either the current one or the predicted next one) setting requests_hold_until_ at its (predicted) end
+bool text_collision_(uint32_t now, RttClass rtt_class);
+#endif
+/// @brief Looks for a queued (or in-flight GET) request for the same register the new one could be merged into
+Request *request_coalesce_(RequestClass request_class, HEXFRAME::COMMAND command, register_id_t register_id);
+/// @brief Selects the class queue to be served next according to request_scheduling_ (no state change)
+RequestQueue *request_select_();
+/// @brief Dequeues the head request of the selected class queue (or of the next one if nullptr)
+Request *request_pop_(RequestQueue *queue = nullptr);
+/// @brief Sends as many queued requests as allowed by the pipeline window (and by the room in the tx ring)
+void request_dispatch_();
 void request_trigger_(Request *request);
 void request_response_(Request *request, const HexFrame *response, Error error);
+/// @brief Releases the (already unlinked) request along with its joined ones invoking their callbacks
+void request_complete_(Request *request, const HexFrame *response, Error error);
+/// @brief Moves the retries whose backoff expired back into their class queue (as long as its depth allows)
+void request_retry_(uint32_t now);
+/// @brief Errors caused by a lost or corrupted frame (either the request or its reply) which are worth a retry
+static bool is_retryable_(Error error) {
+  switch (error) {
+    case Error::CHECKSUM:
+    case Error::CODING:
+    case Error::OVERFLOW:
+    case Error::TIMEOUT:
+    case Error::UNEXPECTED:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// @brief Read transactions with registers still to be submitted
+ReadTransaction *read_transactions_{nullptr};
+/// @brief Submits as many reads as the queue allows for every transaction in read_transactions_
+void read_submit_();
+void read_complete_(ReadTransaction *transaction);
+
+// Adaptive timeouts: RTO = SRTT + 4 * RTTVAR (clamped) where the estimators are fed by the replies
+// not delayed by a TEXT frame (the device holds the HEX replies until the end of the TEXT frame).
+RttEstimator rtt_estimators_[RttClass_COUNT]{};
+uint32_t request_timeout_min_{VEDIRECT_COMMAND_TIMEOUT_MIN_MILLIS};
+uint32_t request_timeout_max_{VEDIRECT_COMMAND_TIMEOUT_MILLIS};
+static RttClass rtt_class_(uint8_t command) {
+  switch (command) {
+    case HEXFRAME::COMMAND::Get:
+      return RttGet;
+    case HEXFRAME::COMMAND::Set:
+      return RttSet;
+    case HEXFRAME::COMMAND::Ping:
+      return RttPing;
+    default:
+      return RttCommand;
+  }
+}
+void rtt_sample_(RttClass rtt_class, uint32_t rtt);
+
+struct RetryPolicy {
+  uint8_t max_attempts;  // 0 or 1: no retries
+  bool priority;
+  uint16_t backoff;
+} retry_policies_[RttClass_COUNT]{};
+
+RequestStats request_stats_[RttClass_COUNT]{};
+#ifdef USE_SENSOR
+sensor::Sensor *request_stats_sensors_[RequestStatsSensor_COUNT]{};
+/// @brief queue wait, rtt and latency of all the command classes over the current publishing period
+Histogram request_stats_period_[3]{};
+uint32_t request_stats_publish_time_{VEDIRECT_STATS_PUBLISH_MILLIS};
+void request_stats_publish_(uint32_t now);
+#endif
+
+// Pipelining: pipeline_cwnd_ is the AIMD window in 1/256 units (so that additive
+// increase could be 1/window per reply i.e. +1 per round trip)
+uint8_t pipeline_window_{1};
+uint16_t pipeline_cwnd_{256};
+uint8_t pipeline_window_current_() const {
+  return std::max<uint8_t>(1, std::min<uint8_t>(this->pipeline_window_, this->pipeline_cwnd_ >> 8));
+}
 
 /// @brief Polling context for HEX registers on connection
 HexRegistersMap::iterator polling_registers_it_;
+/// @brief Polling requests queued or in flight
+uint8_t polling_pending_{0};
+uint16_t polling_count_{0};
+uint32_t polling_start_{0};
+float polling_rate_{0};
+bool polling_sweep_{false};
+uint32_t freshness_ttl_{VEDIRECT_FRESHNESS_TTL_MILLIS};
+uint32_t polling_skipped_{0};
+uint32_t polling_sweep_skipped_{0};  // polling_skipped_ when the sweep began
+/// @brief Keeps up to the pipeline window polling requests queued/in flight
+void poll_registers_();
 void poll_next_register_();
+/// @brief Logs the connection time polling statistics once all of the registers were polled (or skipped)
+void poll_sweep_end_();
+/// @brief Issues a polling GET: adaptive_register (if any) will have its polling period adapted on reply
+void poll_register_(register_id_t register_id, Register *adaptive_register);
+
+// Periodic polling: registers with an update_interval are kept in a hashed timer wheel (linked
+// through Register::Polling::next) and moved to the poll_due_ list when their time comes so that
+// poll_registers_ could feed them to the request queue as soon as there's room (and budget).
+static_assert((VEDIRECT_POLL_WHEEL_SIZE & (VEDIRECT_POLL_WHEEL_SIZE - 1)) == 0,
+              "VEDIRECT_POLL_WHEEL_SIZE must be a power of 2");
+static_assert((VEDIRECT_POLL_WHEEL_TICK_MILLIS & (VEDIRECT_POLL_WHEEL_TICK_MILLIS - 1)) == 0,
+              "VEDIRECT_POLL_WHEEL_TICK_MILLIS must be a power of 2");
+Register *poll_wheel_[VEDIRECT_POLL_WHEEL_SIZE]{};
+/// @brief Start time of the next wheel tick to be processed
+uint32_t poll_wheel_time_{0};
+uint16_t poll_wheel_size_{0};
+Register *poll_due_head_{nullptr};
+Register *poll_due_tail_{nullptr};
+/// @brief Maximum number of periodic polling requests per second (0: unlimited)
+uint32_t poll_budget_{0};
+/// @brief Periodic polling token bucket (milli-requests)
+uint32_t poll_tokens_{0};
+uint32_t poll_tokens_time_{0};
+/// @brief Scheduled periodic polling load (milli-requests/s) i.e. the sum of 1/interval
+uint32_t poll_load_{0};
+void poll_adapt_(Register *reg, const HexFrame *response);
+void poll_schedule_(Register *reg, uint32_t due);
+void poll_wheel_tick_(uint32_t millis_);
 
 void on_frame_hex_(const RxHexFrame &hexframe) override;
 void on_frame_hex_error_(FrameHandler::Error error) override;
@@ -338,8 +899,36 @@ void on_frame_hex_error_(FrameHandler::Error error) override;
 bool auto_create_text_entities_{true};
 
 TextRegistersMap text_registers_;
+/// @brief Fingerprints (payload_hash_) of the last two TEXT frames (some devices alternate two different blocks)
+uint32_t textframe_fingerprints_[2]{};
+/// @brief millis() of the end of the last TEXT frame (replies delayed by it are not sampled for round trip times)
+uint32_t textframe_end_{0};
+#if defined(VEDIRECT_USE_HEXFRAME)
+/// @brief TEXT frames cadence tracking: a burst starts with a TEXT frame not closely following the previous one
+bool textframe_sync_{true};
+bool textframe_receiving_{false};
+uint8_t textframe_cadence_misses_{0};
+uint32_t textframe_burst_start_{0};
+TextCadence textframe_cadence_{};
+/// @brief Detects the beginning of a TEXT frame (called once data was decoded) and updates the cadence
+inline void textframe_begin_(uint32_t now);
+#endif
+/// @brief TEXT frame 'shapes' cache: the label and the registers bound (nullptr if none) to each record
+/// position of the last two (different) frame layouts. Devices emit their records always in the same order
+/// so that the binding (even a missing one) is usually resolved by a single compare against the expected slot.
+struct TextShapeSlot {
+  TextRegistersMap::bucket_type *bucket;
+  // zero padded (not terminated when VEDIRECT_NAME_LEN - 1 chars long)
+  char name[VEDIRECT_NAME_LEN - 1];
+};
+TextShapeSlot text_shapes_[2][VEDIRECT_TEXT_SHAPE_SIZE]{};
+TextShapeSlot *text_shape_{text_shapes_[0]};
+static bool text_shape_match_(const TextShapeSlot &slot, const char *name) {
+  return !strncmp(slot.name, name, sizeof(slot.name));
+}
 
-void on_frame_text_(TextRecord **text_records, uint8_t text_records_count) override;
+bool on_frame_text_name_(TextRecord &text_record, const char *name, uint8_t hash) override;
+void on_frame_text_(const TextFrame &textframe) override;
 void on_frame_text_error_(FrameHandler::Error error) override;
 #endif
 }
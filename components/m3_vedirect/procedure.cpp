@@ -0,0 +1,98 @@
+#include "procedure.h"
+#include "manager.h"
+
+#if defined(VEDIRECT_USE_HEXFRAME) && VEDIRECT_PROCEDURE_POOL_SIZE
+namespace esphome {
+namespace m3_vedirect {
+
+static const char *const TAG = "m3_vedirect.procedure";
+
+// coroutine frames storage: a slot is in use when allocated (the promise is registered in
+// Procedure::promises_ only once constructed within the frame)
+static struct {
+  alignas(std::max_align_t) uint8_t frame[VEDIRECT_PROCEDURE_FRAME_SIZE];
+} procedure_frames_[VEDIRECT_PROCEDURE_POOL_SIZE];
+static bool procedure_frames_used_[VEDIRECT_PROCEDURE_POOL_SIZE];
+
+Procedure::promise_type *Procedure::promises_[VEDIRECT_PROCEDURE_POOL_SIZE];
+
+static uint8_t procedure_index_(const void *ptr) {
+  return ((const uint8_t *) ptr - procedure_frames_[0].frame) / sizeof(procedure_frames_[0]);
+}
+
+Procedure::promise_type::promise_type() { Procedure::promises_[procedure_index_(this)] = this; }
+
+Procedure::promise_type::~promise_type() { Procedure::promises_[procedure_index_(this)] = nullptr; }
+
+void *Procedure::promise_type::operator new(size_t size) noexcept {
+  if (size > VEDIRECT_PROCEDURE_FRAME_SIZE) {
+    ESP_LOGE(TAG, "Coroutine frame (%u bytes) exceeds VEDIRECT_PROCEDURE_FRAME_SIZE", (unsigned) size);
+    return nullptr;
+  }
+  for (uint8_t i = 0; i < VEDIRECT_PROCEDURE_POOL_SIZE; ++i) {
+    if (!procedure_frames_used_[i]) {
+      procedure_frames_used_[i] = true;
+      return procedure_frames_[i].frame;
+    }
+  }
+  ESP_LOGE(TAG, "No slot available (VEDIRECT_PROCEDURE_POOL_SIZE=%u)", (unsigned) VEDIRECT_PROCEDURE_POOL_SIZE);
+  return nullptr;
+}
+
+void Procedure::promise_type::operator delete(void *frame) noexcept {
+  procedure_frames_used_[procedure_index_(frame)] = false;
+}
+
+uint8_t Procedure::get_count() {
+  uint8_t count = 0;
+  for (auto used : procedure_frames_used_)
+    count += used;
+  return count;
+}
+
+void Procedure::RequestAwaiter::await_suspend(handle_t handle) {
+  auto promise = this->promise = &handle.promise();
+  promise->manager = this->manager;
+  // the awaiter lives in the (suspended) coroutine frame: the callback only flags the procedure
+  // as ready so that it will be resumed from the Manager::loop (i.e. not nested in the reply processing)
+  this->manager->request(this->command, this->register_id, this->data_size ? &this->data : nullptr, this->data_size,
+                         [this](const HexFrame *response, uint8_t error) {
+                           this->result.error = error;
+                           if (response) {
+                             this->result.flags = response->flags();
+                             this->result.value = response->safe_data_u32();
+                           }
+                           this->promise->ready = true;
+                         });
+}
+
+void Procedure::SleepAwaiter::await_suspend(handle_t handle) {
+  auto &promise = handle.promise();
+  promise.manager = this->manager;
+  promise.wake_time = millis() + this->duration;
+  promise.sleeping = true;
+}
+
+void Procedure::resume_(Manager *manager, uint32_t now) {
+  // resumed procedures could end (or start new ones) while iterating: just look at the slots again
+  for (auto &promise : promises_) {
+    if (promise && (promise->manager == manager) &&
+        (promise->ready || (promise->sleeping && ((int32_t) (now - promise->wake_time) >= 0)))) {
+      promise->ready = promise->sleeping = false;
+      handle_t::from_promise(*promise).resume();
+    }
+  }
+}
+
+void Procedure::cancel_(Manager *manager) {
+  for (auto &promise : promises_) {
+    if (promise && (promise->manager == manager)) {
+      ESP_LOGD(manager->get_logtag(), "Procedure cancelled");
+      handle_t::from_promise(*promise).destroy();
+    }
+  }
+}
+
+}  // namespace m3_vedirect
+}  // namespace esphome
+#endif  // defined(VEDIRECT_USE_HEXFRAME) && VEDIRECT_PROCEDURE_POOL_SIZE
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "defines.h"
+#include "ve_reg_frame.h"
+
+#if defined(VEDIRECT_USE_HEXFRAME) && VEDIRECT_PROCEDURE_POOL_SIZE
+#include <coroutine>
+#include <cstddef>
+
+namespace esphome {
+namespace m3_vedirect {
+
+/// @brief Return type of the (C++20) coroutines implementing multi-step device procedures
+/// through the awaitable Manager api (co_get/co_set/co_command/co_sleep):
+///
+///   Procedure calibrate(Manager *manager) {
+///     auto bat_type = co_await manager->co_get(0xEDF1);
+///     if (bat_type.error)
+///       co_return;
+///     co_await manager->co_set<uint16_t>(0xEDF7, 1440);
+///     auto verify = co_await manager->co_get(0xEDF7);
+///     ...
+///   }
+///
+/// The coroutine starts running when called (up to its first co_await) and is then resumed from the
+/// Manager::loop so that it never blocks it. The frames are allocated from a fixed pool of
+/// VEDIRECT_PROCEDURE_POOL_SIZE slots (VEDIRECT_PROCEDURE_FRAME_SIZE bytes each): when no slot is
+/// available (or the frame doesn't fit) the coroutine is not started and the returned Procedure is 'false'.
+/// A suspended procedure holds no request slot (only the request being awaited does) and it is
+/// destroyed (i.e. cancelled) when the link of the Manager it is waiting on disconnects.
+class Procedure {
+ public:
+  struct promise_type {
+    /// @brief The Manager driving the resumption (set when awaiting)
+    Manager *manager{nullptr};
+    /// @brief millis() at which the awaited sleep expires (see sleeping)
+    uint32_t wake_time{0};
+    bool ready{false};
+    bool sleeping{false};
+
+    promise_type();
+    ~promise_type();
+    static void *operator new(size_t size) noexcept;
+    static void operator delete(void *frame) noexcept;
+
+    Procedure get_return_object() { return Procedure(true); }
+    static Procedure get_return_object_on_allocation_failure() { return Procedure(false); }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() {}
+  };
+  typedef std::coroutine_handle<promise_type> handle_t;
+
+  /// @brief Outcome of an awaited request
+  struct Result {
+    /// @brief Manager::Error code (NONE when succesful)
+    uint8_t error;
+    uint8_t flags;
+    /// @brief The (up to 4 bytes) data of the reply
+    uint32_t value;
+  };
+
+  /// @brief Awaitable sending a request (see Manager::co_get/co_set/co_command)
+  struct RequestAwaiter {
+    Manager *manager;
+    promise_type *promise;
+    register_id_t register_id;
+    HEXFRAME::COMMAND command;
+    uint8_t data_size;
+    uint32_t data;
+    Result result;
+    bool await_ready() const { return false; }
+    void await_suspend(handle_t handle);
+    Result await_resume() const { return this->result; }
+  };
+
+  /// @brief Awaitable suspending the procedure for a while (see Manager::co_sleep)
+  struct SleepAwaiter {
+    Manager *manager;
+    uint32_t duration;
+    bool await_ready() const { return !this->duration; }
+    void await_suspend(handle_t handle);
+    void await_resume() const {}
+  };
+
+  explicit operator bool() const { return this->started_; }
+
+  /// @brief Number of procedures currently alive
+  static uint8_t get_count();
+
+ protected:
+  friend class Manager;
+  explicit Procedure(bool started) : started_(started) {}
+  bool started_;
+
+  /// @brief Resumes the procedures of 'manager' whose awaited request completed or sleep expired
+  static void resume_(Manager *manager, uint32_t now);
+  /// @brief Destroys the procedures suspended on 'manager'
+  static void cancel_(Manager *manager);
+
+  static promise_type *promises_[VEDIRECT_PROCEDURE_POOL_SIZE];
+};
+
+}  // namespace m3_vedirect
+}  // namespace esphome
+#endif  // defined(VEDIRECT_USE_HEXFRAME) && VEDIRECT_PROCEDURE_POOL_SIZE
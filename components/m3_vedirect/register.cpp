@@ -93,7 +93,20 @@ Register *Register::cascade_dispatcher_(Register *_register) {
 }
 
 #if defined(VEDIRECT_USE_HEXFRAME)
-void WritableRegister::request_set_(uint32_t value, std::function<void(const HexFrame *, uint8_t)> &&callback) {
+void Register::set_update_interval(uint32_t update_interval) {
+  if (!this->polling_)
+    this->polling_ = new Polling{};
+  this->polling_->interval = this->polling_->interval_min = this->polling_->interval_max = update_interval;
+}
+
+void Register::set_adaptive_polling(uint32_t interval_min, uint32_t threshold) {
+  if (auto polling = this->polling_) {
+    polling->interval_min = std::min(interval_min, polling->interval_max);
+    polling->threshold = threshold;
+  }
+}
+
+void WritableRegister::request_set_(uint32_t value, Delegate<void(const HexFrame *, uint8_t)> &&callback) {
   this->manager->request_set(this->reg_def_->register_id, &value,
                              HEXFRAME::DATA_TYPE_TO_SIZE[this->reg_def_->data_type], std::move(callback));
 }
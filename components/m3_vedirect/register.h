@@ -66,18 +66,74 @@ class Register : public ValueBucket<register_id_t, Register> {
 
   const REG_DEF *get_reg_def() const { return this->reg_def_; }
 
+  /// @brief Origin of the last frame dispatched to this register (either changing its value or not).
+  enum UpdateSource : uint8_t {
+    NoUpdate,  // never updated since the link (re)connected or stale
+    Text,      // TEXT frame record
+    HexAsync,  // HEX Async (0xA) frame
+    HexReply,  // HEX Get/Set reply
+    UpdateSource_COUNT,
+  };
+  UpdateSource get_update_source() const { return this->update_source_; }
+  /// @brief millis() of the last update (meaningless when get_update_source() == NoUpdate)
+  uint32_t get_last_update() const { return this->last_update_; }
+  /// @brief true if updated less than 'ttl' millis before 'now'
+  bool is_fresh(uint32_t now, uint32_t ttl) const {
+    return (this->update_source_ != NoUpdate) && ((now - this->last_update_) < ttl);
+  }
+
 #if defined(VEDIRECT_USE_HEXFRAME)
+  /// @brief Periodic polling (HEX GET) configuration and state. This is only allocated for
+  /// registers configured with an update_interval (managed by the Manager timer wheel).
+  struct Polling {
+    uint32_t interval;      // effective polling period (millis)
+    uint32_t interval_min;  // adaptive polling floor (== interval_max when not adaptive)
+    uint32_t interval_max;  // configured update_interval
+    uint32_t threshold;     // adaptive polling: raw value change considered significant
+    int32_t value;          // adaptive polling: raw value of the last reply
+    bool value_ok;
+    uint32_t due;
+    Register *next;  // timer wheel slot/due list link
+  };
+  /// @brief Period (millis) of the periodic polling of this register (not set: only polled on connection).
+  /// Must be set before Manager::setup() (i.e. from yaml generated code).
+  void set_update_interval(uint32_t update_interval);
+  /// @brief Enables adaptive polling: the period shrinks (down to interval_min) when successive replies differ
+  /// by more than threshold (raw register units) and grows back to update_interval when the value is stable.
+  void set_adaptive_polling(uint32_t interval_min, uint32_t threshold);
+  const Polling *get_polling() const { return this->polling_; }
+
   typedef FrameHandler::RxHexFrame RxHexFrame;
   typedef void (*parse_hex_func_t)(Register *hex_register, const RxHexFrame *hexframe);
   inline void parse_hex(const RxHexFrame *hexframe) { this->parse_hex_(this, hexframe); }
 #endif
 #if defined(VEDIRECT_USE_TEXTFRAME)
-  typedef void (*parse_text_func_t)(Register *hex_register, const char *text_value);
-  inline void parse_text(const char *text_value) { this->parse_text_(this, text_value); }
+  typedef FrameHandler::TextRecord TextRecord;
+  typedef void (*parse_text_func_t)(Register *hex_register, const TextRecord &text_record, const char *text_value);
+  /// @brief Dispatches a TEXT record. 'text_value' is the (null terminated) record value while
+  /// text_record.numeric (when text_record.numeric_ok) already carries its integer representation.
+  inline void parse_text(const TextRecord &text_record, const char *text_value) {
+    this->parse_text_(this, text_record, text_value);
+  }
 #endif
 
  protected:
   const REG_DEF *reg_def_{nullptr};
+  /// @brief Hash of the last raw payload (HEX data or TEXT value) dispatched to this register (0: none).
+  /// The Manager checks it before dispatching so that unchanged payloads are not parsed (and published) again.
+  uint32_t payload_hash_{0};
+  /// @brief Freshness tracking (see is_fresh): maintained by the Manager on every dispatch, even when
+  /// the payload didn't change.
+  uint32_t last_update_{0};
+  UpdateSource update_source_{NoUpdate};
+  inline void set_updated_(uint32_t time, UpdateSource source) {
+    this->last_update_ = time;
+    this->update_source_ = source;
+  }
+
+#if defined(VEDIRECT_USE_HEXFRAME)
+  Polling *polling_{nullptr};
+#endif
 
 #if defined(VEDIRECT_USE_HEXFRAME) && defined(VEDIRECT_USE_TEXTFRAME)
   Register(parse_hex_func_t parse_hex_func = parse_hex_empty_, parse_text_func_t parse_text_func = parse_text_empty_)
@@ -114,7 +170,7 @@ class Register : public ValueBucket<register_id_t, Register> {
 
 #if defined(VEDIRECT_USE_TEXTFRAME)
   parse_text_func_t parse_text_;
-  static void parse_text_empty_(Register *hex_register, const char *text_value) {}
+  static void parse_text_empty_(Register *hex_register, const TextRecord &text_record, const char *text_value) {}
 #endif
 
   /// @brief Drops the platform 'build_entity' for the specified platform
@@ -144,7 +200,7 @@ class WritableRegister : public Register {
 #endif
 
 #if defined(VEDIRECT_USE_HEXFRAME)
-  void request_set_(uint32_t value, std::function<void(const HexFrame *, uint8_t)> &&callback);
+  void request_set_(uint32_t value, Delegate<void(const HexFrame *, uint8_t)> &&callback);
 #endif
 };
 
@@ -205,9 +261,9 @@ class RegisterDispatcher final : public Register {
   }
 #endif
 #if defined(VEDIRECT_USE_TEXTFRAME)
-  static void parse_text_default_(Register *hex_register, const char *text_value) {
+  static void parse_text_default_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
     for (auto _register : static_cast<RegisterDispatcher *>(hex_register)->registers_) {
-      _register->parse_text(text_value);
+      _register->parse_text(text_record, text_value);
     }
   }
 #endif
@@ -12,8 +12,6 @@
 
 #include "../manager.h"
 
-#include <cinttypes>
-
 namespace esphome {
 namespace m3_vedirect {
 
@@ -162,15 +160,13 @@ void Select::parse_hex_enum_(Register *hex_register, const RxHexFrame *hex_frame
 #endif  // defined(VEDIRECT_USE_HEXFRAME)
 
 #if defined(VEDIRECT_USE_TEXTFRAME)
-void Select::parse_text_default_(Register *hex_register, const char *text_value) {
+void Select::parse_text_default_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
   static_cast<Select *>(hex_register)->parse_string_(text_value);
 }
 
-void Select::parse_text_enum_(Register *hex_register, const char *text_value) {
-  char *endptr;
-  ENUM_DEF::enum_t enum_value = strtoumax(text_value, &endptr, 0);
-  if (*endptr == 0)
-    static_cast<Select *>(hex_register)->parse_enum_(enum_value);
+void Select::parse_text_enum_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
+  if (text_record.numeric_ok)
+    static_cast<Select *>(hex_register)->parse_enum_((ENUM_DEF::enum_t) text_record.numeric);
 }
 #endif  // defined(VEDIRECT_USE_TEXTFRAME)
 
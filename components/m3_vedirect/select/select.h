@@ -80,8 +80,8 @@ class Select final : public WritableRegister, public esphome::select::Select {
   static void parse_hex_enum_(Register *hexregister, const RxHexFrame *hexframe);
 #endif
 #if defined(VEDIRECT_USE_TEXTFRAME)
-  static void parse_text_default_(Register *hex_register, const char *text_value);
-  static void parse_text_enum_(Register *hex_register, const char *text_value);
+  static void parse_text_default_(Register *hex_register, const TextRecord &text_record, const char *text_value);
+  static void parse_text_enum_(Register *hex_register, const TextRecord &text_record, const char *text_value);
 #endif
 
   // optimized publish_state bypassing index checks since we're mantaining our
@@ -1,11 +1,49 @@
 from esphome.components import sensor
+import esphome.const as ec
 
 from .. import VEDirectPlatform, ve_reg
 
+# Manager special sensors: requests diagnostics (see Manager::RequestStatsSensor)
+_diagnostic_latency_sensor_schema = sensor.sensor_schema(
+    unit_of_measurement=ec.UNIT_MILLISECOND,
+    accuracy_decimals=0,
+    state_class=ec.STATE_CLASS_MEASUREMENT,
+    entity_category="diagnostic",
+)
+_diagnostic_counter_sensor_schema = sensor.sensor_schema(
+    accuracy_decimals=0,
+    state_class=ec.STATE_CLASS_TOTAL_INCREASING,
+    entity_category="diagnostic",
+)
+
 PLATFORM = VEDirectPlatform(
     "sensor",
     sensor,
-    {},
+    {
+        **{
+            f"request_{histogram}_{statistic}": VEDirectPlatform.CustomEntityDef(
+                _diagnostic_latency_sensor_schema, "VEDIRECT_USE_HEXFRAME"
+            )
+            for histogram in ("queue_wait", "rtt", "latency")
+            for statistic in ("p50", "p95", "max")
+        },
+        **{
+            f"request_{counter}": VEDirectPlatform.CustomEntityDef(
+                _diagnostic_counter_sensor_schema, "VEDIRECT_USE_HEXFRAME"
+            )
+            for counter in (
+                "timeouts",
+                "unexpected",
+                "remote_errors",
+                "flags_errors",
+                "queue_full",
+                "retries",
+                "retry_successes",
+                "collisions_avoided",
+                "late_replies",
+            )
+        },
+    },
     (ve_reg.CLASS.NUMERIC,),
     True,
 )
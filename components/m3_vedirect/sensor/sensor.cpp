@@ -150,19 +150,19 @@ const Sensor::parse_hex_func_t Sensor::DATA_TYPE_TO_PARSE_HEX_FUNC_[REG_DEF::DAT
 #endif  // defined(VEDIRECT_USE_HEXFRAME)
 
 #if defined(VEDIRECT_USE_TEXTFRAME)
-void Sensor::parse_text_default_(Register *hex_register, const char *text_value) {
+void Sensor::parse_text_default_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
   Sensor *sensor = static_cast<Sensor *>(hex_register);
-  char *endptr;
-  float value = strtof(text_value, &endptr) * sensor->text_scale_;
-  if (*endptr) {
-    // failed conversion
-    if (!std::isnan(sensor->raw_state)) {
-      sensor->publish_state(NAN);
-    }
-  } else {
+  if (text_record.numeric_ok) {
+    float value = (text_record.numeric_unsigned ? (float) (uint32_t) text_record.numeric : text_record.numeric) *
+                  sensor->text_scale_;
     if (sensor->raw_state != value) {
       sensor->publish_state(value);
     }
+  } else {
+    // not a number
+    if (!std::isnan(sensor->raw_state)) {
+      sensor->publish_state(NAN);
+    }
   }
 }
 #endif  // defined(VEDIRECT_USE_TEXTFRAME)
@@ -44,7 +44,7 @@ class Sensor final : public NumericRegister, public Register, public esphome::se
   static const parse_hex_func_t DATA_TYPE_TO_PARSE_HEX_FUNC_[];
 #endif
 #if defined(VEDIRECT_USE_TEXTFRAME)
-  static void parse_text_default_(Register *hex_register, const char *text_value);
+  static void parse_text_default_(Register *hex_register, const TextRecord &text_record, const char *text_value);
 #endif
 };
 
@@ -8,8 +8,6 @@
 
 #include "../manager.h"
 
-#include <cinttypes>
-
 namespace esphome {
 namespace m3_vedirect {
 
@@ -127,23 +125,19 @@ void Switch::parse_hex_enum_(Register *hex_register, const RxHexFrame *hex_frame
 #endif  // defined(VEDIRECT_USE_HEXFRAME)
 
 #if defined(VEDIRECT_USE_TEXTFRAME)
-void Switch::parse_text_default_(Register *hex_register, const char *text_value) {
+void Switch::parse_text_default_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
   static_cast<Switch *>(hex_register)->publish_state(!strcasecmp(text_value, "ON"));
 }
 
-void Switch::parse_text_bitmask_(Register *hex_register, const char *text_value) {
-  char *endptr;
-  BITMASK_DEF::bitmask_t bitmask_value = strtoumax(text_value, &endptr, 0);
-  if (*endptr == 0) {
-    static_cast<Switch *>(hex_register)->parse_bitmask_(bitmask_value);
+void Switch::parse_text_bitmask_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
+  if (text_record.numeric_ok) {
+    static_cast<Switch *>(hex_register)->parse_bitmask_((BITMASK_DEF::bitmask_t) text_record.numeric);
   }
 }
 
-void Switch::parse_text_enum_(Register *hex_register, const char *text_value) {
-  char *endptr;
-  ENUM_DEF::enum_t enum_value = strtoumax(text_value, &endptr, 0);
-  if (*endptr == 0) {
-    static_cast<Switch *>(hex_register)->parse_enum_(enum_value);
+void Switch::parse_text_enum_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
+  if (text_record.numeric_ok) {
+    static_cast<Switch *>(hex_register)->parse_enum_((ENUM_DEF::enum_t) text_record.numeric);
   }
 }
 #endif  // defined(VEDIRECT_USE_TEXTFRAME)
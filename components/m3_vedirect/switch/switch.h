@@ -61,9 +61,9 @@ class Switch final : public WritableRegister, public esphome::switch_::Switch {
   static void parse_hex_enum_(Register *hex_register, const RxHexFrame *hex_frame);
 #endif
 #if defined(VEDIRECT_USE_TEXTFRAME)
-  static void parse_text_default_(Register *hex_register, const char *text_value);
-  static void parse_text_bitmask_(Register *hex_register, const char *text_value);
-  static void parse_text_enum_(Register *hex_register, const char *text_value);
+  static void parse_text_default_(Register *hex_register, const TextRecord &text_record, const char *text_value);
+  static void parse_text_bitmask_(Register *hex_register, const TextRecord &text_record, const char *text_value);
+  static void parse_text_enum_(Register *hex_register, const TextRecord &text_record, const char *text_value);
 #endif
 };
 
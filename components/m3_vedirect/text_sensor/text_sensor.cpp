@@ -8,8 +8,6 @@
 
 #include "../manager.h"
 
-#include <cinttypes>
-
 namespace esphome {
 namespace m3_vedirect {
 
@@ -162,34 +160,30 @@ void TextSensor::parse_hex_app_ver_(Register *hex_register, const RxHexFrame *he
 #endif  // defined(VEDIRECT_USE_HEXFRAME)
 
 #if defined(VEDIRECT_USE_TEXTFRAME)
-void TextSensor::parse_text_default_(Register *hex_register, const char *text_value) {
+void TextSensor::parse_text_default_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
   static_cast<TextSensor *>(hex_register)->parse_string_(text_value);
 }
 
-void TextSensor::parse_text_bitmask_(Register *hex_register, const char *text_value) {
+void TextSensor::parse_text_bitmask_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
   // When parsing text records for BITMASK-like values, the TEXT protocol might sometime carry
-  // decimal based values and sometimes hexadecimal base values. This should be automatically
-  // handled by strtoumax
-  char *endptr;
-  BITMASK_DEF::bitmask_t bitmask_value = strtoumax(text_value, &endptr, 0);
-  if (*endptr == 0) {
-    static_cast<TextSensor *>(hex_register)->parse_bitmask_(bitmask_value);
+  // decimal based values and sometimes hexadecimal base values. This is already handled
+  // by the frame parser (see FrameHandler::TextRecord::numeric)
+  if (text_record.numeric_ok) {
+    static_cast<TextSensor *>(hex_register)->parse_bitmask_((BITMASK_DEF::bitmask_t) text_record.numeric);
   } else {
     static_cast<TextSensor *>(hex_register)->parse_string_(text_value);
   }
 }
 
-void TextSensor::parse_text_enum_(Register *hex_register, const char *text_value) {
-  char *endptr;
-  ENUM_DEF::enum_t enum_value = strtoumax(text_value, &endptr, 0);
-  if (*endptr == 0) {
-    static_cast<TextSensor *>(hex_register)->parse_enum_(enum_value);
+void TextSensor::parse_text_enum_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
+  if (text_record.numeric_ok) {
+    static_cast<TextSensor *>(hex_register)->parse_enum_((ENUM_DEF::enum_t) text_record.numeric);
   } else {
     static_cast<TextSensor *>(hex_register)->parse_string_(text_value);
   }
 }
 
-void TextSensor::parse_text_app_ver_(Register *hex_register, const char *text_value) {
+void TextSensor::parse_text_app_ver_(Register *hex_register, const TextRecord &text_record, const char *text_value) {
   // Here we expect to parse either 'FW' or 'FWE' text records. We'll use strlen to decide how to interpret
   // the payload (see https://www.victronenergy.com/upload/documents/VE.Direct-Protocol-3.33.pdf)
   auto len = strlen(text_value);
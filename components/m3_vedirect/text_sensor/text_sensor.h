@@ -44,10 +44,10 @@ class TextSensor final : public Register, public esphome::text_sensor::TextSenso
   static void parse_hex_app_ver_(Register *hex_register, const RxHexFrame *hex_frame);
 #endif
 #if defined(VEDIRECT_USE_TEXTFRAME)
-  static void parse_text_default_(Register *hex_register, const char *text_value);
-  static void parse_text_bitmask_(Register *hex_register, const char *text_value);
-  static void parse_text_enum_(Register *hex_register, const char *text_value);
-  static void parse_text_app_ver_(Register *hex_register, const char *text_value);
+  static void parse_text_default_(Register *hex_register, const TextRecord &text_record, const char *text_value);
+  static void parse_text_bitmask_(Register *hex_register, const TextRecord &text_record, const char *text_value);
+  static void parse_text_enum_(Register *hex_register, const TextRecord &text_record, const char *text_value);
+  static void parse_text_app_ver_(Register *hex_register, const TextRecord &text_record, const char *text_value);
 #endif
 };
 
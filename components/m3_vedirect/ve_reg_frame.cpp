@@ -5,27 +5,51 @@ namespace m3_ve_reg {
 
 #if defined(VEDIRECT_USE_HEXFRAME)
 
-const char HEX_DIGITS_MAP[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+const char HEX_DIGITS_MAP[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+#define HEX_NIBBLE_(c) \
+  (((c) >= '0') && ((c) <= '9') ? (c) - '0' : ((c) >= 'A') && ((c) <= 'F') ? (c) - 'A' + 10 : HEX_NIBBLE_INVALID)
+#define HEX_NIBBLE_ROW_(r) \
+  HEX_NIBBLE_(r + 0x0), HEX_NIBBLE_(r + 0x1), HEX_NIBBLE_(r + 0x2), HEX_NIBBLE_(r + 0x3), HEX_NIBBLE_(r + 0x4), \
+      HEX_NIBBLE_(r + 0x5), HEX_NIBBLE_(r + 0x6), HEX_NIBBLE_(r + 0x7), HEX_NIBBLE_(r + 0x8), HEX_NIBBLE_(r + 0x9), \
+      HEX_NIBBLE_(r + 0xA), HEX_NIBBLE_(r + 0xB), HEX_NIBBLE_(r + 0xC), HEX_NIBBLE_(r + 0xD), HEX_NIBBLE_(r + 0xE), \
+      HEX_NIBBLE_(r + 0xF)
+const uint8_t HEX_NIBBLE_MAP[256] = {
+    HEX_NIBBLE_ROW_(0x00), HEX_NIBBLE_ROW_(0x10), HEX_NIBBLE_ROW_(0x20), HEX_NIBBLE_ROW_(0x30),
+    HEX_NIBBLE_ROW_(0x40), HEX_NIBBLE_ROW_(0x50), HEX_NIBBLE_ROW_(0x60), HEX_NIBBLE_ROW_(0x70),
+    HEX_NIBBLE_ROW_(0x80), HEX_NIBBLE_ROW_(0x90), HEX_NIBBLE_ROW_(0xA0), HEX_NIBBLE_ROW_(0xB0),
+    HEX_NIBBLE_ROW_(0xC0), HEX_NIBBLE_ROW_(0xD0), HEX_NIBBLE_ROW_(0xE0), HEX_NIBBLE_ROW_(0xF0),
+};
+
+// encodes the raw payload straight from the binary frame so that we don't need
+// the (possibly not mirrored) frame encoding
+static inline char *data_to_hex_(char *buf, const uint8_t *data, const uint8_t *data_end) {
+  *buf++ = '0';
+  *buf++ = 'x';
+  for (; data < data_end; ++data) {
+    *buf++ = HEX_DIGITS_MAP[(*data) >> 4];
+    *buf++ = HEX_DIGITS_MAP[(*data) & 0x0F];
+  }
+  *buf = 0;
+  return buf;
+}
 
 bool HexFrame::data_to_hex(std::string &hexdata) const {
-  int encoded_size = this->encoded_end_ - this->encoded_begin_;
-  if (encoded_size > 11) {
-    hexdata = "0x";
-    hexdata.append(this->encoded_begin_ + 8, this->encoded_end_ - 3);
+  int data_size = this->data_size();
+  if (data_size > 0) {
+    hexdata.resize(2 + data_size * 2);
+    data_to_hex_(&hexdata[0], this->data_begin(), this->data_end());
     return true;
   }
   return false;
 }
 
 bool HexFrame::data_to_hex(char *buf, size_t buf_size) const {
-  int encoded_size = this->encoded_end_ - this->encoded_begin_ - 11;
-  if (encoded_size > 0) {
-    if ((encoded_size + 2) >= buf_size)
-      encoded_size = buf_size - 3;
-    buf[0] = '0';
-    buf[1] = 'x';
-    memcpy(buf + 2, this->encoded_begin_ + 8, encoded_size);
-    buf[encoded_size + 2] = 0;
+  int data_size = this->data_size();
+  if (data_size > 0) {
+    if ((size_t) (data_size * 2 + 2) >= buf_size)
+      data_size = (buf_size - 3) / 2;
+    data_to_hex_(buf, this->data_begin(), this->data_begin() + data_size);
     return true;
   }
   return false;
@@ -34,22 +58,18 @@ bool HexFrame::data_to_hex(char *buf, size_t buf_size) const {
 HexFrame::DecodeResult HexFrame::decode(const char *hexdigits, bool addchecksum) {
   HexFrameDecoder decoder;
   decoder.init(this);
-
-  for (;;) {
-    switch (auto result = decoder.decode(*hexdigits++)) {
-      case DecodeResult::Continue:
-        continue;
-      case DecodeResult::Terminated:
-        if (addchecksum) {
-          *this->encoded_end_++ = HEX_DIGITS_MAP[decoder.get_checksum() >> 4];
-          *this->encoded_end_++ = HEX_DIGITS_MAP[decoder.get_checksum() & 0x0F];
-        }
-        *this->encoded_end_++ = '\n';
-        *this->encoded_end_ = 0;
-        return DecodeResult::Valid;
-      default:
-        return result;
-    }
+  // include the terminating '\0' in the span so that the decoder always reaches a termination state
+  switch (auto result = decoder.decode(hexdigits, hexdigits + strlen(hexdigits) + 1)) {
+    case DecodeResult::Terminated:
+      if (addchecksum) {
+        *this->encoded_end_++ = HEX_DIGITS_MAP[decoder.get_checksum() >> 4];
+        *this->encoded_end_++ = HEX_DIGITS_MAP[decoder.get_checksum() & 0x0F];
+      }
+      *this->encoded_end_++ = '\n';
+      *this->encoded_end_ = 0;
+      return DecodeResult::Valid;
+    default:
+      return result;
   }
 }
 
@@ -67,32 +87,302 @@ void HexFrame::command(HEXFRAME::COMMAND command, register_id_t register_id, con
   this->encode_();
 }
 
-void HexFrame::encode_() {
+void HexFrame::encode_() const {
   this->encoded_end_ = this->encoded_begin_;
   int hexframe_size = this->size();
   if (hexframe_size > 0) {
     int encoded_size = 1 + 1 + (hexframe_size - 1) * 2 + 2 + 2;
     if (encoded_size <= (this->encoded_end_of_storage() - this->encoded_begin_)) {
-      *this->encoded_end_++ = ':';
+      char *encoded = this->encoded_end_;
+      *encoded++ = ':';
       const uint8_t *data = this->begin();
+      const uint8_t *data_end = this->end();
       uint8_t checksum = 0x55 - *data;
-      *this->encoded_end_++ = HEX_DIGITS_MAP[(*data) & 0x0F];
-      while (++data < this->end()) {
-        *this->encoded_end_++ = HEX_DIGITS_MAP[(*data) >> 4];
-        *this->encoded_end_++ = HEX_DIGITS_MAP[(*data) & 0x0F];
+      *encoded++ = HEX_DIGITS_MAP[(*data) & 0x0F];
+      while (++data < data_end) {
+        *encoded++ = HEX_DIGITS_MAP[(*data) >> 4];
+        *encoded++ = HEX_DIGITS_MAP[(*data) & 0x0F];
         checksum -= *data;
       }
-      *this->encoded_end_++ = HEX_DIGITS_MAP[checksum >> 4];
-      *this->encoded_end_++ = HEX_DIGITS_MAP[checksum & 0x0F];
-      *this->encoded_end_++ = '\n';
+      *encoded++ = HEX_DIGITS_MAP[checksum >> 4];
+      *encoded++ = HEX_DIGITS_MAP[checksum & 0x0F];
+      *encoded++ = '\n';
+      this->encoded_end_ = encoded;
     }
   }
   *this->rawframe_end_ = 0;
   *this->encoded_end_ = 0;
 }
 
+// (8 digits: at least one iteration of the unrolled loop)
+static constexpr int HEX_BULK_MIN_DIGITS = 8;
+
+HexFrameDecoder::Result HexFrameDecoder::decode(const char *&hexdigits, const char *hexdigits_end) {
+  auto hexframe = this->hexframe_;
+  if (!hexframe)
+    return Result::InitError;
+  // Align on a byte boundary: this is always the case for the command nibble
+  // or when a frame was split in the middle of a byte.
+  if (!this->hinibble_) {
+    if (hexdigits >= hexdigits_end)
+      return Result::Continue;
+    if (auto result = this->decode(*hexdigits++))
+      return result;
+  }
+
+  // Fast path: decode whole bytes (2 digits) while staying inside the raw storage.
+  // Any non-hex digit (terminator or garbage) breaks out and is handled by the per-byte decoder.
+  // Short spans (UART chunks splitting a frame) don't pay back its setup: they go per-byte.
+  if ((hexdigits_end - hexdigits) >= HEX_BULK_MIN_DIGITS) {
+    uint8_t *rawframe = hexframe->rawframe_end_;
+    char *encoded = hexframe->encoded_end_;
+    const char *hexdigits_begin = hexdigits;
+    uint8_t checksum = this->checksum_;
+    int count = (hexdigits_end - hexdigits) / 2;
+    int capacity = this->rawframe_end_of_storage_ - rawframe;
+    if (count > capacity)
+      count = capacity;
+    for (; count >= 4; count -= 4) {
+      const uint8_t *digits = (const uint8_t *) hexdigits;
+      uint8_t n0 = HEX_NIBBLE_MAP[digits[0]], n1 = HEX_NIBBLE_MAP[digits[1]];
+      uint8_t n2 = HEX_NIBBLE_MAP[digits[2]], n3 = HEX_NIBBLE_MAP[digits[3]];
+      uint8_t n4 = HEX_NIBBLE_MAP[digits[4]], n5 = HEX_NIBBLE_MAP[digits[5]];
+      uint8_t n6 = HEX_NIBBLE_MAP[digits[6]], n7 = HEX_NIBBLE_MAP[digits[7]];
+      if ((n0 | n1 | n2 | n3 | n4 | n5 | n6 | n7) & 0xF0)
+        break;
+      rawframe[0] = (n0 << 4) | n1;
+      rawframe[1] = (n2 << 4) | n3;
+      rawframe[2] = (n4 << 4) | n5;
+      rawframe[3] = (n6 << 4) | n7;
+      checksum -= rawframe[0] + rawframe[1] + rawframe[2] + rawframe[3];
+      rawframe += 4;
+      hexdigits += 8;
+    }
+    for (; count > 0; --count) {
+      uint8_t hi = HEX_NIBBLE_MAP[(uint8_t) hexdigits[0]], lo = HEX_NIBBLE_MAP[(uint8_t) hexdigits[1]];
+      if ((hi | lo) & 0xF0)
+        break;
+      checksum -= *rawframe++ = (hi << 4) | lo;
+      hexdigits += 2;
+    }
+    if (this->mirror_) {
+      memcpy(encoded, hexdigits_begin, hexdigits - hexdigits_begin);
+      hexframe->encoded_end_ = encoded + (hexdigits - hexdigits_begin);
+    }
+    hexframe->rawframe_end_ = rawframe;
+    this->checksum_ = checksum;
+  }
+
+  // Slow path: trailing odd digit, terminator, errors
+  while (hexdigits < hexdigits_end) {
+    if (auto result = this->decode(*hexdigits++))
+      return result;
+  }
+  return Result::Continue;
+}
+
 #endif  // defined(VEDIRECT_USE_HEXFRAME)
 
+#if defined(VEDIRECT_USE_TEXTFRAME)
+// SWAR helpers: 4 bytes at a time are checked against the frame/record delimiters so
+// that we only fall back to the per-byte state machine when something meaningful is in the word.
+// This is used to quickly skip (garbage) data while in State::Idle and to tokenize TEXT records.
+#define SWAR_ONES_ 0x01010101u
+#define SWAR_HIGHS_ 0x80808080u
+// non-zero if any byte in 'word' equals 'c'
+#define SWAR_MATCH_(word, c) ((((word) ^ (SWAR_ONES_ * (c))) - SWAR_ONES_) & ~((word) ^ (SWAR_ONES_ * (c))) & SWAR_HIGHS_)
+// SWAR byte sum (modulo 256) accumulation: 2 x 16 bits lanes of (even/odd) bytes
+#define SWAR_SUM_(lanes, word) lanes += ((word) &0x00FF00FF) + (((word) >> 8) & 0x00FF00FF)
+#define SWAR_SUM_FOLD_(lanes) (uint8_t)((lanes) + ((lanes) >> 16))
+#define IDLE_DELIMITER_(data) (((data) == ':') || ((data) == '\n') || ((data) == '\r'))
+
+/// @brief Returns the first byte in [data_begin, data_end) being a frame delimiter (':', '\n', '\r')
+/// or data_end if none
+static uint8_t *scan_idle_(uint8_t *data_begin, uint8_t *data_end) {
+  for (; (data_begin < data_end) && ((uintptr_t) data_begin & 3); ++data_begin) {
+    if (IDLE_DELIMITER_(*data_begin))
+      return data_begin;
+  }
+  for (; (data_end - data_begin) >= 4; data_begin += 4) {
+    uint32_t word;
+    memcpy(&word, __builtin_assume_aligned(data_begin, 4), 4);
+    if (SWAR_MATCH_(word, ':') | SWAR_MATCH_(word, '\n') | SWAR_MATCH_(word, '\r'))
+      break;
+  }
+  for (; data_begin < data_end; ++data_begin) {
+    if (IDLE_DELIMITER_(*data_begin))
+      return data_begin;
+  }
+  return data_end;
+}
+
+template<char D0, char D1, char D2>
+inline uint8_t *FrameHandler::frame_text_copy_(uint8_t *data_begin, uint8_t *data_end) {
+  uint32_t lanes = 0;
+  data_begin = this->frame_text_copy_<D0, D1, D2>(data_begin, data_end, lanes);
+  this->text_checksum_ += SWAR_SUM_FOLD_(lanes);
+  return data_begin;
+}
+
+template<char D0, char D1, char D2>
+inline uint8_t *FrameHandler::frame_text_copy_(uint8_t *data_begin, uint8_t *data_end, uint32_t &lanes) {
+  char *write = this->text_record_write_;
+  // the per-byte path always keeps the last char of the record for the terminator
+  auto count = this->text_record_write_end_ - write - 1;
+  if (count > (data_end - data_begin))
+    count = data_end - data_begin;
+  for (count /= 4; count; --count, data_begin += 4, write += 4) {
+    // the word is entirely stored but the write pointer only advances up to the delimiter (if any)
+    uint32_t word;
+    memcpy(&word, data_begin, 4);
+    memcpy(write, &word, 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    // SWAR_MATCH_ is only exact on the lowest flagged byte: we need the first byte in the lowest bits
+    word = __builtin_bswap32(word);
+#endif
+    if (uint32_t match = SWAR_MATCH_(word, D0) | SWAR_MATCH_(word, D1) | SWAR_MATCH_(word, D2)) {
+      // the lowest flagged byte is always a real match: keep the bytes preceding it
+      int length = __builtin_ctz(match) / 8;
+      SWAR_SUM_(lanes, word & ((1u << (8 * length)) - 1));
+      data_begin += length;
+      write += length;
+      break;
+    }
+    SWAR_SUM_(lanes, word);
+  }
+  this->text_record_write_ = write;
+  return data_begin;
+}
+
+inline void FrameHandler::frame_text_numeric_(TextRecord &text_record, const char *value, const char *value_end) {
+  text_record.numeric_ok = 0;
+  text_record.numeric_unsigned = 0;
+  uint32_t numeric = 0;
+  if (((value_end - value) > 2) && (value[0] == '0') && ((value[1] | 0x20) == 'x')) {
+    value += 2;
+    if ((value_end - value) > 8)
+      return;
+    for (; value < value_end; ++value) {
+      uint8_t digit = *value - '0';
+      if (digit > 9) {
+        digit = (*value | 0x20) - 'a';
+        if (digit > 5)
+          return;
+        digit += 10;
+      }
+      numeric = (numeric << 4) | digit;
+    }
+    text_record.numeric = (int32_t) numeric;
+  } else {
+    bool negative = (value < value_end) && (*value == '-');
+    value += negative;
+    // a same length comparison against the int32 (negative) or uint32 limits saves any overflow check in the loop
+    auto length = value_end - value;
+    if ((length == 0) || (length > 10) ||
+        ((length == 10) && (memcmp(value, negative ? "2147483648" : "4294967295", 10) > 0)))
+      return;
+    for (; value < value_end; ++value) {
+      uint8_t digit = *value - '0';
+      if (digit > 9)
+        return;
+      numeric = numeric * 10 + digit;
+    }
+    text_record.numeric = negative ? (int32_t) (0u - numeric) : (int32_t) numeric;
+    if (negative)
+      numeric = 0;
+  }
+  text_record.numeric_unsigned = numeric > INT32_MAX;
+  text_record.numeric_ok = 1;
+}
+
+inline uint8_t *FrameHandler::frame_text_copy_name_(uint8_t *data_begin, uint8_t *data_end, uint32_t &lanes) {
+  const char *name = this->text_record_write_;
+  data_begin = this->frame_text_copy_<'\t', ':', ':'>(data_begin, data_end, lanes);
+  uint8_t hash = this->text_label_hash_;
+  for (; name < this->text_record_write_; ++name)
+    hash = text_label_hash(hash, *name);
+  this->text_label_hash_ = hash;
+  return data_begin;
+}
+
+inline uint8_t *FrameHandler::frame_text_copy_name_(uint8_t *data_begin, uint8_t *data_end) {
+  uint32_t lanes = 0;
+  data_begin = this->frame_text_copy_name_(data_begin, data_end, lanes);
+  this->text_checksum_ += SWAR_SUM_FOLD_(lanes);
+  return data_begin;
+}
+
+inline uint8_t *FrameHandler::frame_text_skip_(uint8_t *data_begin, uint8_t *data_end, uint8_t &checksum) {
+  uint32_t lanes = 0;
+  // values being skipped are not bounded in size so we periodically fold the lanes
+  for (int fold = 128; (data_end - data_begin) >= 4; data_begin += 4) {
+    uint32_t word;
+    memcpy(&word, data_begin, 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap32(word);
+#endif
+    if (uint32_t match = SWAR_MATCH_(word, '\n') | SWAR_MATCH_(word, ':')) {
+      int length = __builtin_ctz(match) / 8;
+      SWAR_SUM_(lanes, word & ((1u << (8 * length)) - 1));
+      data_begin += length;
+      break;
+    }
+    SWAR_SUM_(lanes, word);
+    if (!--fold) {
+      checksum += SWAR_SUM_FOLD_(lanes);
+      lanes = 0;
+      fold = 128;
+    }
+  }
+  checksum += SWAR_SUM_FOLD_(lanes);
+  return data_begin;
+}
+
+inline uint8_t *FrameHandler::frame_text_records_(uint8_t *data_begin, uint8_t *data_end) {
+  // lanes are folded at every record so they can't overflow (into the checksum bits)
+  static_assert(VEDIRECT_NAME_LEN + VEDIRECT_VALUE_LEN < 512, "SWAR_SUM_ lanes overflow");
+  uint8_t checksum = this->text_checksum_;
+  uint32_t lanes = 0;
+  for (;; checksum += SWAR_SUM_FOLD_(lanes), lanes = 0) {
+    if (this->frame_state_ == State::Value) {
+      data_begin = this->frame_text_copy_<'\n', '\r', ':'>(data_begin, data_end, lanes);
+      if (((data_end - data_begin) < 2) || (data_begin[0] != '\r') || (data_begin[1] != '\n'))
+        break;
+      data_begin += 2;
+      lanes += '\r' + '\n';
+      this->frame_text_value_end_();
+    } else {
+      data_begin = this->frame_text_skip_(data_begin, data_end, checksum);
+      if ((data_begin >= data_end) || (*data_begin != '\n'))
+        break;
+      ++data_begin;
+      lanes += '\n';
+      this->frame_text_value_skip_end_();
+    }
+    if (!this->frame_text_name_start_()) {
+      this->on_frame_text_error_(Error::RECORD_OVERFLOW);
+      this->frame_state_ = State::Idle;
+      break;
+    }
+    data_begin = this->frame_text_copy_name_(data_begin, data_end, lanes);
+    if ((data_begin >= data_end) || (*data_begin != '\t')) {
+      this->frame_state_ = State::Name;
+      break;
+    }
+    ++data_begin;
+    lanes += '\t';
+    if (this->frame_text_name_end_()) {
+      this->frame_text_checksum_start_();
+      this->frame_state_ = State::Checksum;
+      break;
+    }
+    this->frame_state_ = this->frame_text_name_bind_();
+  }
+  this->text_checksum_ = checksum + SWAR_SUM_FOLD_(lanes);
+  return data_begin;
+}
+#endif  // defined(VEDIRECT_USE_TEXTFRAME)
+
 #if defined(VEDIRECT_USE_HEXFRAME) && defined(VEDIRECT_USE_TEXTFRAME)
 void FrameHandler::decode(uint8_t *data_begin, uint8_t *data_end) {
   uint8_t data;
@@ -100,17 +390,17 @@ handle_state:
   switch (this->frame_state_) {
     case State::Name:
     handle_state_name:
-      while (data_begin < data_end) {
+      while ((data_begin = this->frame_text_copy_name_(data_begin, data_end)) < data_end) {
         data = *data_begin++;
         switch (data) {
           case '\t':  // end of name
             this->text_checksum_ += '\t';
-            *this->text_record_write_ = 0;
-            if (strcmp(this->text_record_->name, "Checksum")) {
-              this->frame_text_value_start_();
-              this->frame_state_ = State::Value;
-              goto handle_state_value;
+            if (!this->frame_text_name_end_()) {
+              if ((this->frame_state_ = this->frame_text_name_bind_()) == State::Value)
+                goto handle_state_value;
+              goto handle_state_skip;
             } else {  // the Checksum record indicates a EOF
+              this->frame_text_checksum_start_();
               this->frame_state_ = State::Checksum;
               goto handle_state_checksum;
             }
@@ -119,9 +409,10 @@ handle_state:
             goto handle_state_hex;
           default:
             this->text_checksum_ += data;
+            this->text_label_hash_ = text_label_hash(this->text_label_hash_, data);
             *this->text_record_write_ = data;
             if (++this->text_record_write_ >= this->text_record_write_end_) {
-              this->on_frame_text_error_(Error::NAME_OVERFLOW);
+              this->on_frame_text_error_(this->frame_text_overflow_(Error::NAME_OVERFLOW));
               this->frame_state_ = State::Idle;
               goto handle_state_idle;
             }
@@ -130,18 +421,20 @@ handle_state:
       break;
     case State::Value:
     handle_state_value:
-      while (data_begin < data_end) {
+      data_begin = this->frame_text_records_(data_begin, data_end);
+      if (this->frame_state_ != State::Value)
+        goto handle_state;
+      while ((data_begin = this->frame_text_copy_<'\n', '\r', ':'>(data_begin, data_end)) < data_end) {
         data = *data_begin++;
         switch (data) {
           case '\n':  // start of next record
             this->text_checksum_ += '\n';
-            *this->text_record_write_ = 0;
-            if (++this->text_records_count_ >= VEDIRECT_RECORDS_COUNT) {
+            this->frame_text_value_end_();
+            if (!this->frame_text_name_start_()) {
               this->on_frame_text_error_(Error::RECORD_OVERFLOW);
               this->frame_state_ = State::Idle;
               goto handle_state_idle;
             }
-            this->frame_text_name_start_();
             this->frame_state_ = State::Name;
             goto handle_state_name;
           case '\r':  // pre-start of next record
@@ -154,37 +447,62 @@ handle_state:
             this->text_checksum_ += data;
             *this->text_record_write_ = data;
             if (++this->text_record_write_ >= this->text_record_write_end_) {
-              this->on_frame_text_error_(Error::VALUE_OVERFLOW);
+              this->on_frame_text_error_(this->frame_text_overflow_(Error::VALUE_OVERFLOW));
               this->frame_state_ = State::Idle;
               goto handle_state_idle;
             }
         }
       }
       break;
+    case State::Skip:
+    handle_state_skip:
+      data_begin = this->frame_text_records_(data_begin, data_end);
+      if (this->frame_state_ != State::Skip)
+        goto handle_state;
+      while (data_begin < data_end) {
+        data = *data_begin++;
+        switch (data) {
+          case '\n':  // start of next record
+            this->text_checksum_ += '\n';
+            this->frame_text_value_skip_end_();
+            // this can't fail since we've just released the record storage
+            this->frame_text_name_start_();
+            this->frame_state_ = State::Name;
+            goto handle_state_name;
+          case ':':  // HEX FRAME
+            this->frame_hex_start_();
+            goto handle_state_hex;
+          default:
+            this->text_checksum_ += data;
+        }
+      }
+      break;
     case State::Idle:
     handle_state_idle:
-      while (data_begin < data_end) {
+      while ((data_begin = scan_idle_(data_begin, data_end)) < data_end) {
         switch (*data_begin++) {
           case ':':  // HEX FRAME
             this->frame_hex_start_();
             goto handle_state_hex;
           case '\n':  // start of TEXT FRAME
             this->text_checksum_ += '\n';
-            this->text_records_count_ = 0;
+            this->frame_text_start_();
             this->frame_text_name_start_();
             this->frame_state_ = State::Name;
             goto handle_state_name;
-          case '\r':  // pre-start of TEXT FRAME
+          default:  // '\r': pre-start of TEXT FRAME
             this->text_checksum_ = '\r';
-          default:
             break;
         }
       }
       break;
     case State::Hex:
     handle_state_hex:
-      while (data_begin < data_end) {
-        switch (this->hexframe_decoder_.decode(*data_begin++)) {
+      if (data_begin < data_end) {
+        const char *hexdigits = (const char *) data_begin;
+        auto result = this->hexframe_decoder_.decode(hexdigits, (const char *) data_end);
+        data_begin = (uint8_t *) hexdigits;
+        switch (result) {
           case HexFrameDecoder::Result::Continue:
             break;
           case HexFrameDecoder::Result::Valid:
@@ -197,13 +515,19 @@ handle_state:
             goto handle_state;
           case HexFrameDecoder::Result::Overflow:
             this->on_frame_hex_error_(Error::OVERFLOW);
-            this->frame_state_ = State::Idle;
-            goto handle_state_idle;
+            goto handle_state_hex_resync;
           default:
             // case HexFrameDecoder::Result::CodingError:
             // case HexFrameDecoder::Result::Terminated:
             this->on_frame_hex_error_(Error::CODING);
+          handle_state_hex_resync:
             this->frame_state_ = State::Idle;
+            // the offending char might be the start of a new frame (i.e. the terminator
+            // of the broken one was lost): restart decoding from there
+            if (data_begin[-1] == ':') {
+              this->frame_hex_start_();
+              goto handle_state_hex;
+            }
             goto handle_state_idle;
         }
       }
@@ -214,7 +538,7 @@ handle_state:
         if ((uint8_t) (this->text_checksum_ + *data_begin++)) {
           this->on_frame_text_error_(Error::CHECKSUM);
         } else {
-          this->on_frame_text_(this->text_records_, this->text_records_count_);
+          this->on_frame_text_(this->textframe_);
         }
         this->frame_state_ = State::Idle;
         goto handle_state_idle;
@@ -228,20 +552,19 @@ void FrameHandler::decode(uint8_t *data_begin, uint8_t *data_end) {
   switch (this->frame_state_) {
     case State::Idle:
     handle_state_idle:
-      while (data_begin < data_end) {
-        switch (*data_begin++) {
-          case ':':  // HEX FRAME
-            this->frame_hex_start_();
-            goto handle_state_hex;
-          default:
-            break;
-        }
+      if (auto hex_begin = (uint8_t *) memchr(data_begin, ':', data_end - data_begin)) {
+        data_begin = hex_begin + 1;
+        this->frame_hex_start_();
+        goto handle_state_hex;
       }
       break;
     case State::Hex:
     handle_state_hex:
-      while (data_begin < data_end) {
-        switch (this->hexframe_decoder_.decode(*data_begin++)) {
+      if (data_begin < data_end) {
+        const char *hexdigits = (const char *) data_begin;
+        auto result = this->hexframe_decoder_.decode(hexdigits, (const char *) data_end);
+        data_begin = (uint8_t *) hexdigits;
+        switch (result) {
           case HexFrameDecoder::Result::Continue:
             break;
           case HexFrameDecoder::Result::Valid:
@@ -254,13 +577,19 @@ void FrameHandler::decode(uint8_t *data_begin, uint8_t *data_end) {
             goto handle_state_idle;
           case HexFrameDecoder::Result::Overflow:
             this->on_frame_hex_error_(Error::OVERFLOW);
-            this->frame_state_ = State::Idle;
-            goto handle_state_idle;
+            goto handle_state_hex_resync;
           default:
             // case HexFrameDecoder::Result::CodingError:
             // case HexFrameDecoder::Result::Terminated:
             this->on_frame_hex_error_(Error::CODING);
+          handle_state_hex_resync:
             this->frame_state_ = State::Idle;
+            // the offending char might be the start of a new frame (i.e. the terminator
+            // of the broken one was lost): restart decoding from there
+            if (data_begin[-1] == ':') {
+              this->frame_hex_start_();
+              goto handle_state_hex;
+            }
             goto handle_state_idle;
         }
       }
@@ -274,17 +603,17 @@ handle_state:
   switch (this->frame_state_) {
     case State::Name:
     handle_state_name:
-      while (data_begin < data_end) {
+      while ((data_begin = this->frame_text_copy_name_(data_begin, data_end)) < data_end) {
         data = *data_begin++;
         switch (data) {
           case '\t':  // end of name
             this->text_checksum_ += '\t';
-            *this->text_record_write_ = 0;
-            if (strcmp(this->text_record_->name, "Checksum")) {
-              this->frame_text_value_start_();
-              this->frame_state_ = State::Value;
-              goto handle_state_value;
+            if (!this->frame_text_name_end_()) {
+              if ((this->frame_state_ = this->frame_text_name_bind_()) == State::Value)
+                goto handle_state_value;
+              goto handle_state_skip;
             } else {  // the Checksum record indicates a EOF
+              this->frame_text_checksum_start_();
               this->frame_state_ = State::Checksum;
               goto handle_state_checksum;
             }
@@ -293,9 +622,10 @@ handle_state:
             goto handle_state_hex;
           default:
             this->text_checksum_ += data;
+            this->text_label_hash_ = text_label_hash(this->text_label_hash_, data);
             *this->text_record_write_ = data;
             if (++this->text_record_write_ >= this->text_record_write_end_) {
-              this->on_frame_text_error_(Error::NAME_OVERFLOW);
+              this->on_frame_text_error_(this->frame_text_overflow_(Error::NAME_OVERFLOW));
               this->frame_state_ = State::Idle;
               goto handle_state_idle;
             }
@@ -304,18 +634,20 @@ handle_state:
       break;
     case State::Value:
     handle_state_value:
-      while (data_begin < data_end) {
+      data_begin = this->frame_text_records_(data_begin, data_end);
+      if (this->frame_state_ != State::Value)
+        goto handle_state;
+      while ((data_begin = this->frame_text_copy_<'\n', '\r', ':'>(data_begin, data_end)) < data_end) {
         data = *data_begin++;
         switch (data) {
           case '\n':  // start of next record
             this->text_checksum_ += '\n';
-            *this->text_record_write_ = 0;
-            if (++this->text_records_count_ >= VEDIRECT_RECORDS_COUNT) {
+            this->frame_text_value_end_();
+            if (!this->frame_text_name_start_()) {
               this->on_frame_text_error_(Error::RECORD_OVERFLOW);
               this->frame_state_ = State::Idle;
               goto handle_state_idle;
             }
-            this->frame_text_name_start_();
             this->frame_state_ = State::Name;
             goto handle_state_name;
           case '\r':  // pre-start of next record
@@ -328,41 +660,61 @@ handle_state:
             this->text_checksum_ += data;
             *this->text_record_write_ = data;
             if (++this->text_record_write_ >= this->text_record_write_end_) {
-              this->on_frame_text_error_(Error::VALUE_OVERFLOW);
+              this->on_frame_text_error_(this->frame_text_overflow_(Error::VALUE_OVERFLOW));
               this->frame_state_ = State::Idle;
               goto handle_state_idle;
             }
         }
       }
       break;
+    case State::Skip:
+    handle_state_skip:
+      data_begin = this->frame_text_records_(data_begin, data_end);
+      if (this->frame_state_ != State::Skip)
+        goto handle_state;
+      while (data_begin < data_end) {
+        data = *data_begin++;
+        switch (data) {
+          case '\n':  // start of next record
+            this->text_checksum_ += '\n';
+            this->frame_text_value_skip_end_();
+            // this can't fail since we've just released the record storage
+            this->frame_text_name_start_();
+            this->frame_state_ = State::Name;
+            goto handle_state_name;
+          case ':':  // HEX FRAME
+            this->frame_hex_start_();
+            goto handle_state_hex;
+          default:
+            this->text_checksum_ += data;
+        }
+      }
+      break;
     case State::Idle:
     handle_state_idle:
-      while (data_begin < data_end) {
+      while ((data_begin = scan_idle_(data_begin, data_end)) < data_end) {
         switch (*data_begin++) {
           case ':':  // HEX FRAME
             this->frame_hex_start_();
             goto handle_state_hex;
           case '\n':  // start of TEXT FRAME
             this->text_checksum_ += '\n';
-            this->text_records_count_ = 0;
+            this->frame_text_start_();
             this->frame_text_name_start_();
             this->frame_state_ = State::Name;
             goto handle_state_name;
-          case '\r':  // pre-start of TEXT FRAME
+          default:  // '\r': pre-start of TEXT FRAME
             this->text_checksum_ = '\r';
-          default:
             break;
         }
       }
       break;
     case State::Hex:
     handle_state_hex:
-      while (data_begin < data_end) {
-        switch (*data_begin++) {
-          case '\n':
-            this->frame_state_ = this->frame_state_backup_;
-            goto handle_state;
-        }
+      if (auto hex_end = (uint8_t *) memchr(data_begin, '\n', data_end - data_begin)) {
+        data_begin = hex_end + 1;
+        this->frame_state_ = this->frame_state_backup_;
+        goto handle_state;
       }
       break;
     case State::Checksum:
@@ -371,7 +723,7 @@ handle_state:
         if ((uint8_t) (this->text_checksum_ + *data_begin++)) {
           this->on_frame_text_error_(Error::CHECKSUM);
         } else {
-          this->on_frame_text_(this->text_records_, this->text_records_count_);
+          this->on_frame_text_(this->textframe_);
         }
         this->frame_state_ = State::Idle;
         goto handle_state_idle;
@@ -380,6 +732,11 @@ handle_state:
   }
 }
 #endif
+
+#if defined(VEDIRECT_USE_HEXFRAME)
+static_assert(HexFrameConstT<0>(HEXFRAME::COMMAND::Ping).encoded()[3] == '4', "HexFrameConstT checksum failure");
+static_assert(HexFrameConstT<3>(HEXFRAME::COMMAND::Get, 0xEDF1).encoded_size() == 11, "HexFrameConstT size failure");
+#endif
 /*
 static_assert(sizeof(HexFrame::Record) == 8, "HexFrame::Record size failure");
 static_assert(sizeof(HexFrame) == 20, "HexFrame size failure = ");
@@ -23,15 +23,41 @@ namespace m3_ve_reg {
 #ifndef VEDIRECT_HEXFRAME_MAX_SIZE
 #define VEDIRECT_HEXFRAME_MAX_SIZE 64
 #endif
+// Default behavior for the FrameHandler HEX decoder: when 1 the incoming HEX digits
+// are also mirrored into the RxHexFrame 'encoded_' buffer. When 0 the decoder only
+// stores the raw (binary) frame and the HEX representation is lazily rebuilt
+// (see HexFrame::encoded()) only by consumers actually needing it (logging, raw publishing).
+#ifndef VEDIRECT_HEXFRAME_RX_MIRROR
+#define VEDIRECT_HEXFRAME_RX_MIRROR 1
+#endif
 #endif  // defined(VEDIRECT_USE_HEXFRAME)
 
 #if defined(VEDIRECT_USE_TEXTFRAME)
 #define VEDIRECT_NAME_LEN 9
 #define VEDIRECT_VALUE_LEN 33
-#define VEDIRECT_RECORDS_COUNT 22
+// Size (in bytes) of the statically allocated storage (slab) for an incoming TEXT frame.
+// Names and values are tightly packed from the start of the slab while record
+// descriptors are allocated from its end so that the number of records adapts
+// to the actual frame layout (many short records or fewer long ones).
+// Records discarded by the handler (see FrameHandler::on_frame_text_name_) release their storage.
+// Each stored record takes its nul terminated name and value plus a TextRecord descriptor
+// (12 bytes on 32 bit MCUs): 768 fits the largest single block seen from devices (a 30 records
+// BMV block is ~240 bytes of payload + 360 of descriptors) with some headroom and is a multiple
+// of the descriptor size on both 32 and 64 bit hosts.
+#ifndef VEDIRECT_TEXTFRAME_MAX_SIZE
+#define VEDIRECT_TEXTFRAME_MAX_SIZE 768
+#endif
 #endif  // defined(VEDIRECT_USE_TEXTFRAME)
 
 #if defined(VEDIRECT_USE_HEXFRAME)
+/// @brief Lookup tables for the HEX frame codec.
+/// HEX_NIBBLE_MAP maps any input char to its nibble value ('0'..'9', 'A'..'F')
+/// or to HEX_NIBBLE_INVALID so that a whole run of digits can be validated
+/// by just OR-ing the looked up values.
+#define HEX_NIBBLE_INVALID 0xFF
+extern const char HEX_DIGITS_MAP[16];
+extern const uint8_t HEX_NIBBLE_MAP[256];
+
 /// @brief  Helper class to manage HEX frames. It allows building an internal
 /// binary representation and encoding/decoding
 /// to the HEX format suitable for serial communication.
@@ -64,24 +90,23 @@ struct HexFrame {
   inline int capacity() const { return end_of_storage() - this->rawframe_begin_; }
   inline int size() const { return this->rawframe_end_ - this->rawframe_begin_; }
 
-  inline const char *encoded() {
+  // Encoded data accessors: these lazily (re)build the HEX representation when not
+  // available (i.e. when the frame was decoded without mirroring) so that they're safe to use on const frames
+  inline const char *encoded() const {
     if (this->needs_encoding_())
       this->encode_();
     return encoded_begin_;
   }
-  inline const char *encoded() const { return encoded_begin_; }
-  inline const char *encoded_end() {
+  inline const char *encoded_end() const {
     if (this->needs_encoding_())
       this->encode_();
     return encoded_end_;
   }
-  inline const char *encoded_end() const { return encoded_end_; }
-  inline int encoded_size() {
+  inline int encoded_size() const {
     if (this->needs_encoding_())
       this->encode_();
     return encoded_end_ - encoded_begin_;
   }
-  inline int encoded_size() const { return encoded_end_ - encoded_begin_; }
 
   // Shortcut accessors for general HEX frames data.
   // Beware these are generally not 'safe' and heavily depends
@@ -170,11 +195,12 @@ struct HexFrame {
   uint8_t *rawframe_end_;
 
   char *const encoded_begin_;
-  char *encoded_end_;
+  // mutable since the encoding is a (lazily built) cache of the raw frame
+  mutable char *encoded_end_;
 
   inline void invalidate_encoding_() { this->encoded_end_ = this->encoded_begin_; }
   inline bool needs_encoding_() const { return this->encoded_end_ == this->encoded_begin_; }
-  void encode_();
+  void encode_() const;
 };
 
 /// @brief Provides a static storage implementation for HexFrame
@@ -219,18 +245,78 @@ struct HexFrame_Set : public HexFrameT<7> {
   template<typename T> HexFrame_Set(register_id_t register_id, T data) { this->command_set(register_id, data); }
 };
 
+/// @brief Fully encoded (and checksummed) HEX frame built through constexpr constructors so that
+/// constant frames (i.e. PING or a known register GET) are encoded at compile time and could be sent
+/// as they are. At runtime it works as a lightweight encoder straight into the HEX representation
+/// (no raw frame storage). The payload (register id + flags + data) is limited to HF_DATA_SIZE bytes.
+template<std::size_t HF_DATA_SIZE> struct HexFrameConstT {
+ public:
+  static constexpr size_t ALLOCATED_ENCODED_SIZE = HexFrameT<HF_DATA_SIZE>::ALLOCATED_ENCODED_SIZE;
+
+  /// @brief Builds a plain command frame
+  constexpr HexFrameConstT(HEXFRAME::COMMAND command) {
+    this->begin_(command);
+    this->end_();
+  }
+  /// @brief Builds a command GET/SET register frame ('data' is copied as is i.e. little endian)
+  constexpr HexFrameConstT(HEXFRAME::COMMAND command, register_id_t register_id, const uint8_t *data = nullptr,
+                           size_t data_size = 0) {
+    this->begin_(command);
+    this->push_(register_id & 0xFF);
+    this->push_(register_id >> 8);
+    this->push_(0);  // flags
+    for (size_t i = 0; i < data_size; ++i)
+      this->push_(data[i]);
+    this->end_();
+  }
+
+  constexpr const char *encoded() const { return this->encoded_; }
+  constexpr int encoded_size() const { return this->encoded_size_; }
+
+ protected:
+  // :[COMMAND][DATA...][CHECKSUMHIGH][CHECKSUMLOW]\n\0
+  char encoded_[ALLOCATED_ENCODED_SIZE]{};
+  uint8_t encoded_size_{0};
+  uint8_t checksum_{0x55};
+
+  static constexpr char hex_digit_(uint8_t nibble) { return nibble < 10 ? '0' + nibble : 'A' - 10 + nibble; }
+  constexpr void begin_(uint8_t command) {
+    this->encoded_[0] = ':';
+    this->encoded_[1] = hex_digit_(command & 0x0F);
+    this->encoded_size_ = 2;
+    this->checksum_ -= command;
+  }
+  constexpr void push_(uint8_t data) {
+    this->encoded_[this->encoded_size_++] = hex_digit_(data >> 4);
+    this->encoded_[this->encoded_size_++] = hex_digit_(data & 0x0F);
+    this->checksum_ -= data;
+  }
+  constexpr void end_() {
+    uint8_t checksum = this->checksum_;
+    this->encoded_[this->encoded_size_++] = hex_digit_(checksum >> 4);
+    this->encoded_[this->encoded_size_++] = hex_digit_(checksum & 0x0F);
+    this->encoded_[this->encoded_size_++] = '\n';
+    this->encoded_[this->encoded_size_] = 0;
+  }
+};
+
 class HexFrameDecoder {
  public:
   typedef HexFrame::DecodeResult Result;
 
-  void init(HexFrame *hexframe) {
+  /// @brief Binds the decoder to a new HexFrame
+  /// @param hexframe
+  /// @param mirror when false the decoder only stores the raw frame leaving the
+  /// hexframe encoding invalidated (it will be lazily rebuilt if needed)
+  void init(HexFrame *hexframe, bool mirror = true) {
     this->checksum_ = 0x55;
     this->hinibble_ = false;
+    this->mirror_ = mirror;
     this->hexframe_ = hexframe;
     this->rawframe_end_of_storage_ = hexframe->end_of_storage();
     hexframe->rawframe_end_ = hexframe->rawframe_begin_;
     *hexframe->rawframe_end_ = 0;
-    hexframe->encoded_end_ = hexframe->encoded_begin_ + 1;
+    hexframe->encoded_end_ = mirror ? hexframe->encoded_begin_ + 1 : hexframe->encoded_begin_;
     *hexframe->encoded_end_ = 0;
   }
 
@@ -249,7 +335,7 @@ class HexFrameDecoder {
   /// encoded (hex) string so that we can eventually add the checksum. In this scenario,
   /// the stream might (should) end on '\0' and we could then easily add the checksum
   /// if needed. See 'HexFrame::decode'
-  /// While parsing, the input hexdigit is also accumulated into the 'encoded_'
+  /// While parsing (when 'mirror' is enabled), the input hexdigit is also accumulated into the 'encoded_'
   /// buffer of the HexFrame so that it could come handy for later prints or so
   /// without the need to re-encode the frame itself.
   /// @param hexdigit
@@ -263,14 +349,13 @@ class HexFrameDecoder {
       result = Result::Overflow;
       goto decode_exit;
     }
-    if ((hexdigit >= '0') && (hexdigit <= '9')) {
-      *hexframe->encoded_end_++ = hexdigit;
-      hexdigit -= '0';
-    } else if ((hexdigit >= 'A') && (hexdigit <= 'F')) {
-      *hexframe->encoded_end_++ = hexdigit;
-      hexdigit -= 55;
+    uint8_t nibble;
+    if ((nibble = HEX_NIBBLE_MAP[(uint8_t) hexdigit]) != HEX_NIBBLE_INVALID) {
+      if (this->mirror_)
+        *hexframe->encoded_end_++ = hexdigit;
     } else if (hexdigit == '\n') {
-      *hexframe->encoded_end_++ = '\n';
+      if (this->mirror_)
+        *hexframe->encoded_end_++ = '\n';
       if (this->hinibble_) {
         // frame alignment ok
         if (this->checksum_) {
@@ -291,10 +376,10 @@ class HexFrameDecoder {
 
     if (this->hinibble_) {
       this->hinibble_ = false;
-      *hexframe->rawframe_end_ = hexdigit << 4;
+      *hexframe->rawframe_end_ = nibble << 4;
     } else {
       this->hinibble_ = true;
-      *hexframe->rawframe_end_ |= hexdigit;
+      *hexframe->rawframe_end_ |= nibble;
       this->checksum_ -= *hexframe->rawframe_end_++;
     }
     return Result::Continue;
@@ -306,11 +391,23 @@ class HexFrameDecoder {
     return result;
   }
 
+  /// @brief Bulk version of 'decode(char)' working on a whole span of HEX digits.
+  /// Byte-aligned runs of digits are decoded 8 at a time through HEX_NIBBLE_MAP
+  /// (validating the whole chunk at once) while frame boundaries (alignment, terminator,
+  /// errors) are handed over to the per-byte 'decode(char)' so that the resulting
+  /// state is exactly the same as if feeding the span one byte at a time.
+  /// @param hexdigits in/out: start of the span, updated past the last consumed digit
+  /// @param hexdigits_end end of the span
+  /// @return Result::Continue if the whole span was consumed without reaching a
+  /// termination state, else the termination state (as for 'decode(char)')
+  Result decode(const char *&hexdigits, const char *hexdigits_end);
+
   inline uint8_t get_checksum() { return this->checksum_; }
 
  protected:
   HexFrame *hexframe_{};
   bool hinibble_;
+  bool mirror_;
   uint8_t checksum_;
   const uint8_t *rawframe_end_of_storage_;
 };
@@ -334,6 +431,7 @@ class FrameHandler {
 #if defined(VEDIRECT_USE_TEXTFRAME)
     NAME_OVERFLOW = 4,
     VALUE_OVERFLOW = 5,
+    // the TEXT frame doesn't fit in VEDIRECT_TEXTFRAME_MAX_SIZE
     RECORD_OVERFLOW = 6,
 #endif
     _COUNT,
@@ -345,6 +443,8 @@ class FrameHandler {
 #if defined(VEDIRECT_USE_TEXTFRAME)
     Name,
     Value,
+    // parsing the value of a discarded record (see on_frame_text_name_)
+    Skip,
     Checksum,
 #endif
   };
@@ -354,21 +454,89 @@ class FrameHandler {
 #endif
 
 #if defined(VEDIRECT_USE_TEXTFRAME)
+  /// @brief Descriptor of a TEXT record stored in the TextFrame slab.
+  /// Both name and value are null terminated in the slab so that they can
+  /// be directly used as c-strings (the value immediately follows the name terminator).
   struct TextRecord {
-    char name[VEDIRECT_NAME_LEN];
-    char value[VEDIRECT_VALUE_LEN];
+    uint16_t name_offset;
+    uint8_t name_len : 7;
+    /// @brief 'numeric' holds an unsigned value above INT32_MAX (as its raw 32 bits pattern)
+    uint8_t numeric_unsigned : 1;
+    uint8_t value_len : 7;
+    /// @brief The value is a (decimal or '0x' prefixed hexadecimal) integer and 'numeric' holds it
+    uint8_t numeric_ok : 1;
+    /// @brief Integer value of the record (valid if numeric_ok). Hexadecimal and unsigned decimal values
+    /// above INT32_MAX are stored as their raw 32 bits pattern (see numeric_unsigned) so that they can be
+    /// reinterpreted as unsigned (bitmasks/enums).
+    int32_t numeric;
+    /// @brief Opaque binding set by the handler when the record name is parsed (see on_frame_text_name_)
+    void *binding;
+  };
+
+  /// @brief Hash function for TEXT labels. This is computed incrementally while
+  /// parsing the record name so that it's readily available in on_frame_text_name_
+  static constexpr uint8_t text_label_hash(uint8_t hash, char c) { return (hash << 1) + (uint8_t) c; }
+
+  /// @brief Storage for an incoming TEXT frame: a single slab where names/values are packed
+  /// from the beginning while the records descriptors are allocated backward from the end.
+  struct TextFrame {
+   public:
+    /// @brief Number of records in the frame (the 'Checksum' record is not included)
+    uint8_t size() const { return this->records_count_; }
+    /// @brief Access the records in frame order
+    const TextRecord &operator[](uint8_t index) const { return this->records_end_()[-1 - index]; }
+    const char *name(const TextRecord &record) const { return this->slab_ + record.name_offset; }
+    const char *value(const TextRecord &record) const {
+      return this->slab_ + record.name_offset + record.name_len + 1;
+    }
+    /// @brief The packed (null terminated) names and values
+    const char *payload() const { return this->slab_; }
+    /// @brief Size of the packed (null terminated) names and values
+    int payload_size() const { return this->payload_end_ - this->slab_; }
+
+   protected:
+    friend class FrameHandler;
+    static_assert(VEDIRECT_TEXTFRAME_MAX_SIZE <= 65536, "TextRecord offsets are 16 bits");
+    static_assert(VEDIRECT_VALUE_LEN < 128, "TextRecord::value_len is 7 bits");
+    static_assert(VEDIRECT_NAME_LEN < 128, "TextRecord::name_len is 7 bits");
+    static_assert((VEDIRECT_TEXTFRAME_MAX_SIZE % sizeof(TextRecord)) == 0,
+                  "VEDIRECT_TEXTFRAME_MAX_SIZE must be a multiple of sizeof(TextRecord)");
+    uint8_t records_count_{0};
+    const char *payload_end_{slab_};
+    alignas(TextRecord) char slab_[VEDIRECT_TEXTFRAME_MAX_SIZE];
+
+    TextRecord *records_end_() { return (TextRecord *) (this->slab_ + sizeof(this->slab_)); }
+    const TextRecord *records_end_() const { return (const TextRecord *) (this->slab_ + sizeof(this->slab_)); }
   };
 #endif
 
   void reset() { this->frame_state_ = State::Idle; }
   void decode(uint8_t *data_begin, uint8_t *data_end);
 
+ protected:
+#if defined(VEDIRECT_USE_HEXFRAME)
+  /// @brief Enables/disables mirroring of incoming HEX digits into the RxHexFrame encoding.
+  /// Takes effect from the next incoming HEX frame. The component only uses the build time
+  /// default (VEDIRECT_HEXFRAME_RX_MIRROR): this is for handlers measuring both modes (benches).
+  void set_hexframe_mirror(bool mirror) { this->hexframe_mirror_ = mirror; }
+#endif
+#if defined(VEDIRECT_USE_TEXTFRAME)
+  /// @brief Position (in the incoming TEXT frame) of the record being bound in on_frame_text_name_.
+  /// Discarded records are counted too so that this is stable for a given frame layout.
+  uint8_t text_record_index() const { return this->text_record_index_; }
+  /// @brief A TEXT frame is being received: devices reply to HEX requests only after it ends.
+  bool is_textframe_in_progress() const {
+    return (this->frame_state_ != State::Idle) && (this->frame_state_ != State::Hex);
+  }
+#endif
+
  private:
   State frame_state_{State::Idle};
 
 #if defined(VEDIRECT_USE_HEXFRAME)
   RxHexFrame hexframe_;
   HexFrameDecoder hexframe_decoder_;
+  bool hexframe_mirror_{VEDIRECT_HEXFRAME_RX_MIRROR};
 
   virtual void on_frame_hex_(const RxHexFrame &hexframe) {}
   virtual void on_frame_hex_error_(Error error) {}
@@ -381,36 +549,117 @@ class FrameHandler {
   State frame_state_backup_;
 
   uint8_t text_checksum_;
-  // This is a statically preallocated storage for incoming records
-  // TextRecord(s) will be added 'on-demand' (and reused on every new frame parsing)
-  // Having 'nullptr' means the record has not been allocated yet..simple as that.
-  TextRecord *text_records_[VEDIRECT_RECORDS_COUNT]{};
-  uint8_t text_records_count_;
-
-  // buffered pointers to current text record parsing
+  uint8_t text_label_hash_;
+  uint8_t text_record_index_;
+  TextFrame textframe_;
+  // buffered pointers to current text record parsing: the record descriptor
+  // is always the lowest allocated in the slab
   TextRecord *text_record_;
   char *text_record_write_;
   char *text_record_write_end_;
-  inline void frame_text_name_start_() {
-    TextRecord *text_record = this->text_records_[this->text_records_count_];
-    if (!text_record)
-      this->text_records_[this->text_records_count_] = text_record = new TextRecord;
+  inline void frame_text_start_() {
+    this->textframe_.records_count_ = 0;
+    this->text_record_index_ = 0;
+    this->text_record_ = this->textframe_.records_end_();
+    this->text_record_write_ = this->textframe_.slab_;
+  }
+  /// @brief Allocates a new record descriptor and setup the write pointers for its name.
+  /// @return false if the slab is full
+  inline bool frame_text_name_start_() {
+    TextRecord *text_record = this->text_record_ - 1;
+    char *text_record_write_end = (char *) text_record;
+    if (this->text_record_write_ >= text_record_write_end)
+      return false;
+    text_record->name_offset = this->text_record_write_ - this->textframe_.slab_;
     this->text_record_ = text_record;
-    this->text_record_write_ = text_record->name;
-    this->text_record_write_end_ = this->text_record_write_ + sizeof(this->text_record_->name);
+    this->text_label_hash_ = 0;
+    if (text_record_write_end > (this->text_record_write_ + VEDIRECT_NAME_LEN))
+      text_record_write_end = this->text_record_write_ + VEDIRECT_NAME_LEN;
+    this->text_record_write_end_ = text_record_write_end;
+    return true;
+  }
+  /// @brief Terminates the name of the current record
+  /// @return true if this is the 'Checksum' record (i.e. the end of the TEXT frame)
+  inline bool frame_text_name_end_() {
+    const char *name = this->textframe_.slab_ + this->text_record_->name_offset;
+    this->text_record_->name_len = this->text_record_write_ - name;
+    *this->text_record_write_++ = 0;
+    return (this->text_record_->name_len == 8) && !memcmp(name, "Checksum", 8);
+  }
+  /// @brief Lets the handler bind the current record (on_frame_text_name_)
+  /// @return the state for value parsing: Value or Skip when the record is discarded
+  inline State frame_text_name_bind_() {
+    TextRecord *text_record = this->text_record_;
+    bool bound = this->on_frame_text_name_(*text_record, this->textframe_.name(*text_record), this->text_label_hash_);
+    ++this->text_record_index_;
+    if (bound) {
+      this->frame_text_value_start_();
+      return State::Value;
+    }
+    return State::Skip;
   }
   inline void frame_text_value_start_() {
     // current text_record_ already in place since we were parsing the name
-    this->text_record_write_ = this->text_record_->value;
-    this->text_record_write_end_ = this->text_record_write_ + sizeof(this->text_record_->value);
+    char *text_record_write_end = (char *) this->text_record_;
+    if (text_record_write_end > (this->text_record_write_ + VEDIRECT_VALUE_LEN))
+      text_record_write_end = this->text_record_write_ + VEDIRECT_VALUE_LEN;
+    this->text_record_write_end_ = text_record_write_end;
+  }
+  inline void frame_text_value_end_() {
+    TextRecord *text_record = this->text_record_;
+    char *value = this->textframe_.slab_ + text_record->name_offset + text_record->name_len + 1;
+    text_record->value_len = this->text_record_write_ - value;
+    // the value was just copied so it is hot in cache: convert it right away
+    frame_text_numeric_(*text_record, value, this->text_record_write_);
+    *this->text_record_write_++ = 0;
+    ++this->textframe_.records_count_;
+  }
+  /// @brief Parses the record value as a signed decimal (int32) or a '0x' prefixed hexadecimal (32 bits) integer
+  static void frame_text_numeric_(TextRecord &text_record, const char *value, const char *value_end);
+  /// @brief Drops the current (discarded) record releasing its slab storage
+  inline void frame_text_value_skip_end_() {
+    this->text_record_write_ = this->textframe_.slab_ + this->text_record_->name_offset;
+    ++this->text_record_;
+  }
+  inline void frame_text_checksum_start_() {
+    // drop the 'Checksum' record from the slab
+    this->text_record_write_ = this->textframe_.slab_ + this->text_record_->name_offset;
+    ++this->text_record_;
+    this->textframe_.payload_end_ = this->text_record_write_;
+  }
+  /// @brief Fast path for the Name/Value states: copies whole words into the current record
+  /// as long as they don't contain any of the state delimiters and still fit the record.
+  /// @return the updated data_begin: whatever follows is handled by the per-byte state machine
+  template<char D0, char D1, char D2> uint8_t *frame_text_copy_(uint8_t *data_begin, uint8_t *data_end);
+  /// @brief Same as above but accumulating the checksum into SWAR 'lanes'
+  template<char D0, char D1, char D2>
+  uint8_t *frame_text_copy_(uint8_t *data_begin, uint8_t *data_end, uint32_t &lanes);
+  /// @brief Name state fast path: as frame_text_copy_ while also updating the label hash
+  uint8_t *frame_text_copy_name_(uint8_t *data_begin, uint8_t *data_end);
+  uint8_t *frame_text_copy_name_(uint8_t *data_begin, uint8_t *data_end, uint32_t &lanes);
+  /// @brief Skip state fast path: only accumulates the checksum of whole words not containing '\n' or ':'
+  uint8_t *frame_text_skip_(uint8_t *data_begin, uint8_t *data_end, uint8_t &checksum);
+  /// @brief Fast path for the Value/Skip states: parses complete 'value\r\nname\t' sequences without
+  /// going through the per-byte state machine. It stops at the first partial/unexpected token
+  /// eventually updating frame_state_ (Name, Value, Skip, Checksum, Idle on errors).
+  uint8_t *frame_text_records_(uint8_t *data_begin, uint8_t *data_end);
+  /// @brief Discriminates the reason for a name/value write overflow
+  inline Error frame_text_overflow_(Error error) const {
+    return this->text_record_write_end_ == (char *) this->text_record_ ? Error::RECORD_OVERFLOW : error;
   }
-  virtual void on_frame_text_(TextRecord **text_records, uint8_t text_records_count) {}
+  /// @brief Called when a record name has been parsed: the handler can bind the record to
+  /// any context (TextRecord::binding) which will be available in on_frame_text_.
+  /// @param hash the label hash (see text_label_hash)
+  /// @return false to discard the record: its value will only be checksummed and the
+  /// record will not be reported in on_frame_text_
+  virtual bool on_frame_text_name_(TextRecord &text_record, const char *name, uint8_t hash) { return true; }
+  virtual void on_frame_text_(const TextFrame &textframe) {}
   virtual void on_frame_text_error_(Error error) {}
 #endif  // defined(VEDIRECT_USE_TEXTFRAME)
 
   inline void frame_hex_start_() {
 #if defined(VEDIRECT_USE_HEXFRAME)
-    this->hexframe_decoder_.init(&this->hexframe_);
+    this->hexframe_decoder_.init(&this->hexframe_, this->hexframe_mirror_);
 #endif
 #if defined(VEDIRECT_USE_TEXTFRAME)
     this->frame_state_backup_ = this->frame_state_;